@@ -0,0 +1,114 @@
+#include <sys/mman.h>
+#include "arena.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Size of a huge page. Chunks are rounded up to it so that they can be fully backed by them.
+ */
+static const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+
+/**
+ * @brief Arena constructor. Nothing is touched until it is allocated, so reserving more than needed
+ *        only costs address space.
+ *
+ * @param capacity number of bytes mapped upfront. The arena grows past it when needed
+ */
+Arena::Arena(size_t capacity) : _current(0), _used(0) {
+    this->addChunk(capacity);
+}
+
+
+/**
+ * @brief Arena destructor. Unmaps every chunk.
+ */
+Arena::~Arena() {
+    for (const arenaChunkStruct& chunk : this->_chunks) munmap(chunk.base, chunk.size);
+}
+
+
+/**
+ * @brief Maps a new chunk of at least the given size right after the one being filled.
+ *
+ * @param bytes minimum number of bytes
+ */
+void Arena::addChunk(size_t bytes) {
+
+    /* Every chunk is at least twice the last one, so an arena that keeps growing maps a few times */
+    size_t size = this->_chunks.empty() ? 0 : this->_chunks[this->_current].size * 2;
+    size = max(max(size, bytes), HUGE_PAGE_SIZE);
+    size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+    /* Reserved huge pages are tried first. Most systems have none, so transparent huge pages are
+     * asked for on a regular mapping instead */
+    void* base = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (base == MAP_FAILED) {
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (base == MAP_FAILED) throw bad_alloc();
+#ifdef MADV_HUGEPAGE
+        madvise(base, size, MADV_HUGEPAGE);
+#endif
+    }
+
+    arenaChunkStruct chunk = {static_cast<char*>(base), size};
+    size_t position = this->_chunks.empty() ? 0 : this->_current + 1;
+    this->_chunks.insert(this->_chunks.begin() + position, chunk);
+
+}
+
+
+/**
+ * @brief Hands out memory from the arena.
+ *
+ * @param bytes number of bytes
+ * @param alignment required alignment, a power of two
+ * @return pointer to the memory. Throws bad_alloc if no more memory can be mapped
+ */
+void* Arena::allocate(size_t bytes, size_t alignment) {
+
+    size_t start = (this->_used + alignment - 1) & ~(alignment - 1);
+
+    /* Moves on to the next chunk, mapping a new one when the next is missing or too small. Chunks
+     * are mapped aligned to pages, so their start is aligned for any type */
+    while (start + bytes > this->_chunks[this->_current].size) {
+        if (this->_current + 1 == this->_chunks.size() ||
+            this->_chunks[this->_current + 1].size < bytes)
+            this->addChunk(bytes);
+        this->_current++;
+        start = 0;
+    }
+
+    this->_used = start + bytes;
+    return this->_chunks[this->_current].base + start;
+
+}
+
+
+/**
+ * @brief Makes every byte of the arena available again, in O(1). Everything allocated before must no
+ *        longer be used.
+ */
+void Arena::reset() {
+    this->_current = 0;
+    this->_used = 0;
+}
+
+
+/**
+ * @brief Get the Capacity object.
+ *
+ * @return number of bytes mapped
+ */
+size_t Arena::getCapacity() const {
+    size_t capacity = 0;
+    for (const arenaChunkStruct& chunk : this->_chunks) capacity += chunk.size;
+    return capacity;
+}
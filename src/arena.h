@@ -0,0 +1,166 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+
+using namespace std;
+
+
+/**
+ * @brief Monotonic memory arena. Memory is handed out by bumping a pointer through large anonymous
+ *        mappings (backed by huge pages where available) and is never given back one allocation at
+ *        a time: reset() rewinds the whole arena at once, keeping its mappings (and their already
+ *        faulted pages) for whatever is allocated next. Not thread safe.
+ */
+class Arena {
+
+    private:
+
+        /**
+         * @brief Holds one mapping of the arena.
+         *
+         * @param base first byte of the mapping
+         * @param size number of bytes mapped
+         */
+        typedef struct arenaChunkStruct {
+            char* base;
+            size_t size;
+        } arenaChunkStruct;
+
+        /**
+         * @brief Holds every mapping, filled one after the other.
+         */
+        vector<arenaChunkStruct> _chunks;
+
+        /**
+         * @brief Holds the position inside _chunks of the mapping being filled.
+         */
+        size_t _current;
+
+        /**
+         * @brief Holds number of bytes already handed out from the mapping being filled.
+         */
+        size_t _used;
+
+        /**
+         * @brief Maps a new chunk of at least the given size right after the one being filled.
+         *
+         * @param bytes minimum number of bytes
+         */
+        void addChunk(size_t bytes);
+
+    public:
+
+        /**
+         * @brief Arena constructor. Nothing is touched until it is allocated, so reserving more than
+         *        needed only costs address space.
+         *
+         * @param capacity number of bytes mapped upfront. The arena grows past it when needed
+         */
+        explicit Arena(size_t capacity);
+
+        /**
+         * @brief Arena destructor. Unmaps every chunk.
+         */
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Hands out memory from the arena.
+         *
+         * @param bytes number of bytes
+         * @param alignment required alignment, a power of two
+         * @return pointer to the memory. Throws bad_alloc if no more memory can be mapped
+         */
+        void* allocate(size_t bytes, size_t alignment);
+
+        /**
+         * @brief Makes every byte of the arena available again, in O(1). Everything allocated before
+         *        must no longer be used.
+         */
+        void reset();
+
+        /**
+         * @brief Get the Capacity object.
+         *
+         * @return number of bytes mapped
+         */
+        size_t getCapacity() const;
+
+};
+
+
+/**
+ * @brief Standard allocator drawing from an Arena, so that containers (vectors, deques) can live
+ *        inside it. Deallocating is free since the arena is rewound as a whole. Without an arena it
+ *        falls back to the heap, so containers can be used the same way either way.
+ *
+ * @tparam T type of the allocated elements
+ */
+template <class T>
+class ArenaAllocator {
+
+    private:
+
+        /**
+         * @brief Holds the arena memory is drawn from, nullptr to use the heap.
+         */
+        Arena* _arena;
+
+    public:
+
+        typedef T value_type;
+
+        /* Containers always take their allocator along, so memory is never freed into the wrong
+         * place when they are moved, copied or swapped */
+        typedef true_type propagate_on_container_copy_assignment;
+        typedef true_type propagate_on_container_move_assignment;
+        typedef true_type propagate_on_container_swap;
+
+        ArenaAllocator(Arena* arena = nullptr) noexcept : _arena(arena) {};
+
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : _arena(other.getArena()) {};
+
+        T* allocate(size_t count) {
+            if (this->_arena == nullptr) return static_cast<T*>(::operator new(count * sizeof(T)));
+            return static_cast<T*>(this->_arena->allocate(count * sizeof(T), alignof(T)));
+        };
+
+        void deallocate(T* pointer, size_t) noexcept {
+            if (this->_arena == nullptr) ::operator delete(pointer);
+        };
+
+        /**
+         * @brief Get the Arena object.
+         *
+         * @return arena memory is drawn from, nullptr if it is the heap
+         */
+        Arena* getArena() const { return this->_arena; };
+
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& first, const ArenaAllocator<U>& second) {
+    return first.getArena() == second.getArena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& first, const ArenaAllocator<U>& second) {
+    return first.getArena() != second.getArena();
+}
+
+
+/**
+ * @brief Vector whose elements may live inside an arena.
+ */
+template <class T>
+using arenaVector = vector<T, ArenaAllocator<T>>;
+
+
+#endif // ARENA_H
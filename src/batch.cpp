@@ -0,0 +1,131 @@
+#include <atomic>
+#include "batch.h"
+#include "binaryGraph.h"
+#include "componentSolver.h"
+#include "kahnSolver.h"
+#include "levelSolver.h"
+#include "orderSolver.h"
+#include "parallel.h"
+#include "parallelTopological.h"
+#include "reader.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Parses one instance into a reused graph and solves it on the calling thread.
+ *
+ * @param parser parser over the whole stream
+ * @param start first byte of the instance
+ * @param graph graph whose buffers are reused
+ * @param solver engine solving the instance (dfs, kahn, level or scc)
+ * @param order how the dfs engine sorts the instance topologically (dfs or stealing)
+ * @param result where the answer is stored
+ * @return true if the instance was well formed. Otherwise the parser holds the error
+ */
+static bool solveInstance(EdgeListParser& parser, const char* start, Graph& graph,
+                          const string& solver, const string& order, dominoResultStruct& result) {
+
+    int nNodes = 0, nEdges = 0;
+
+    parser.seek(start);
+    if (!parser.readHeader(nNodes, nEdges)) return false;
+    graph.reset(nNodes, nEdges);
+    if (!parser.loadEdges(&graph, nEdges)) return false;
+
+    /* Instances are already solved side by side, so every engine runs with a single worker */
+    if (solver == "kahn") result = solveWithKahn(&graph);
+    else if (solver == "level") result = solveWithLevels(&graph, 1, nullptr);
+    else if (solver == "scc") result = solveWithComponents(&graph);
+    else {
+        topologicalOrder topological = order == "stealing" ? parallelTopologicalOrder(&graph, 1)
+                                                           : graph.dfs();
+        result = graph.hasCycle() ? solveWithComponents(&graph)
+                                  : solveWithOrder(&graph, &topological);
+    }
+
+    return true;
+
+}
+
+
+/**
+ * @brief Solves every instance of a stream of concatenated edge lists, printing one
+ *        "interventions sequence" line per instance in input order. Several instances may be solved
+ *        at once, each worker reusing the same graph and arena for all of its instances.
+ *
+ * @param fd file descriptor to read from
+ * @param solver engine solving every instance (dfs, kahn, level or scc)
+ * @param order how the dfs engine sorts every instance topologically (dfs or stealing)
+ * @param workers number of instances solved at once, 0 to use every hardware thread
+ * @return number of instances solved. Terminates the program at the first malformed instance, after
+ *         printing every answer before it
+ */
+size_t solveBatch(int fd, const string& solver, const string& order, int workers) {
+
+    InputBuffer input(fd);
+    if (!input.getError().empty()) {
+        cerr << input.getError() << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (isBinaryGraph(input.getBegin(), input.getEnd())) {
+        cerr << "batch mode only reads edge lists" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /* Finds where every instance starts. Nothing is validated yet, every instance is parsed
+     * properly by the worker solving it */
+    vector<const char*> instances;
+    EdgeListParser splitter(input.getBegin(), input.getEnd());
+    for (const char* start; (start = splitter.skipInstance()) != nullptr; )
+        instances.push_back(start);
+
+    if (workers <= 0) workers = getDefaultWorkers();
+    workers = (int) max((size_t) 1, min((size_t) workers, instances.size()));
+
+    /* Answers are kept until every instance before them has been printed */
+    vector<dominoResultStruct> results(instances.size());
+    vector<string> errors(instances.size());
+    vector<bool> solved(instances.size(), false);
+    atomic<size_t> next(0);
+    atomic<bool> failed(false);
+    mutex printing;
+    size_t printed = 0;
+
+    /* Instances are handed out in input order, so once one fails every instance before it has
+     * already been taken and is finished before the workers stop */
+    runWorkers(workers, [&](int) {
+
+        Graph graph(0, 0, make_shared<Arena>(0));
+        EdgeListParser parser(input.getBegin(), input.getEnd());
+
+        for (size_t instance; !failed && (instance = next++) < instances.size(); ) {
+
+            if (!solveInstance(parser, instances[instance], graph, solver, order,
+                               results[instance])) {
+                errors[instance] = parser.getError();
+                failed = true;
+            }
+
+            /* Prints every answer that is no longer waiting for an earlier instance */
+            lock_guard<mutex> lock(printing);
+            solved[instance] = true;
+            while (printed < instances.size() && solved[printed] && errors[printed].empty()) {
+                cout << results[printed].interventions << " " << results[printed].sequence << "\n";
+                printed++;
+            }
+
+        }
+
+    });
+    cout.flush();
+
+    if (printed < instances.size()) {
+        cerr << "instance " << printed + 1 << ": " << errors[printed] << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return printed;
+
+}
@@ -0,0 +1,26 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Solves every instance of a stream of concatenated edge lists, printing one
+ *        "interventions sequence" line per instance in input order. Several instances may be solved
+ *        at once, each worker reusing the same graph and arena for all of its instances.
+ *
+ * @param fd file descriptor to read from
+ * @param solver engine solving every instance (dfs, kahn, level or scc)
+ * @param order how the dfs engine sorts every instance topologically (dfs or stealing)
+ * @param workers number of instances solved at once, 0 to use every hardware thread
+ * @return number of instances solved. Terminates the program at the first malformed instance, after
+ *         printing every answer before it
+ */
+size_t solveBatch(int fd, const string& solver, const string& order, int workers);
+
+
+#endif // BATCH_H
@@ -0,0 +1,249 @@
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "componentSolver.h"
+#include "graph.h"
+#include "kahnSolver.h"
+#include "levelSolver.h"
+#include "orderSolver.h"
+#include "parallelTopological.h"
+#include "reader.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Holds what a single benchmark run measured. Sent from the child running it to the parent.
+ *
+ * @param nodes number of nodes in the input
+ * @param edges number of edges in the input
+ * @param parse seconds spent reading the input and building the graph
+ * @param order seconds spent sorting the graph topologically (0 for engines without that phase)
+ * @param path seconds spent finding interventions and longest sequence
+ * @param result answer found, so runs can be checked against each other
+ */
+typedef struct benchmarkRunStruct {
+    int nodes;
+    size_t edges;
+    double parse;
+    double order;
+    double path;
+    dominoResultStruct result;
+} benchmarkRunStruct;
+
+
+/**
+ * @brief Every engine that can be benchmarked. dfs and stealing sort the graph topologically and
+ *        then follow the order, kahn and level find the longest path without a separate order and
+ *        scc condenses the strongly connected components first, as cyclic inputs need.
+ */
+static const char* ENGINES[] = {"dfs", "stealing", "kahn", "level", "scc"};
+
+
+/**
+ * @brief Gets the seconds elapsed since a point in time.
+ *
+ * @param start point in time
+ * @return seconds elapsed
+ */
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+/**
+ * @brief Loads and solves an input with one engine, timing every phase.
+ *
+ * @param input path of the input
+ * @param engine engine solving it
+ * @param workers number of workers, 0 to use every hardware thread
+ * @return what the run measured
+ */
+static benchmarkRunStruct runEngine(const string& input, const string& engine, int workers) {
+
+    benchmarkRunStruct run;
+    memset(&run, 0, sizeof(run));
+
+    int fd = open(input.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << input << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Graph graph = readGraph(fd, workers);
+    run.parse = secondsSince(start);
+    close(fd);
+
+    run.nodes = graph.getNumberOfNodes();
+    run.edges = graph.getNumberOfEdges();
+
+    if (engine == "dfs" || engine == "stealing") {
+        start = chrono::steady_clock::now();
+        topologicalOrder topological = engine == "dfs"
+                                       ? graph.dfs() : parallelTopologicalOrder(&graph, workers);
+        run.order = secondsSince(start);
+        start = chrono::steady_clock::now();
+        run.result = graph.hasCycle() ? solveWithComponents(&graph)
+                                      : solveWithOrder(&graph, &topological);
+        run.path = secondsSince(start);
+    } else {
+        start = chrono::steady_clock::now();
+        if (engine == "kahn") run.result = solveWithKahn(&graph);
+        else if (engine == "level") run.result = solveWithLevels(&graph, workers, nullptr);
+        else run.result = solveWithComponents(&graph);
+        run.path = secondsSince(start);
+    }
+
+    return run;
+
+}
+
+
+/**
+ * @brief Runs an engine on an input inside a child process, so every run starts from a clean heap
+ *        and its peak resident memory can be told apart from the others'.
+ *
+ * @param input path of the input
+ * @param engine engine solving it
+ * @param workers number of workers, 0 to use every hardware thread
+ * @param run where the measurements are stored
+ * @param peakRss where the child's peak resident memory is stored, in KB
+ * @return true if the child finished and reported its measurements
+ */
+static bool forkRun(const string& input, const string& engine, int workers,
+                    benchmarkRunStruct& run, long& peakRss) {
+
+    int channel[2];
+    if (pipe(channel) != 0) return false;
+
+    cout.flush();
+    pid_t child = fork();
+    if (child < 0) return false;
+
+    if (child == 0) {
+        close(channel[0]);
+        benchmarkRunStruct measured = runEngine(input, engine, workers);
+        bool sent = write(channel[1], &measured, sizeof(measured)) == sizeof(measured);
+        _exit(sent ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(channel[1]);
+    ssize_t received = read(channel[0], &run, sizeof(run));
+    close(channel[0]);
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(child, &status, 0, &usage) != child) return false;
+    peakRss = usage.ru_maxrss;
+
+    return received == sizeof(run) && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+
+}
+
+
+/**
+ * @brief Prints how to use this program and terminates it.
+ */
+static void printUsage() {
+    cerr << "Usage: benchmark [--engines dfs,stealing,kahn,level,scc] [--warmup N] [--repeat N]"
+         << " [--workers N] [--format csv|json] input..." << endl;
+    cerr << "\t--engines: comma separated engines to run on every input (default: all)" << endl;
+    cerr << "\t--warmup N: runs discarded before measuring each engine (default: 1)" << endl;
+    cerr << "\t--repeat N: measured runs of each engine (default: 5)" << endl;
+    cerr << "\t--workers N: number of threads used to load and solve (default: all)" << endl;
+    cerr << "\t--format: one row per measured run as csv (default) or a json array" << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/**
+ * @brief Driver code. Every measured run of every engine on every input is printed on stdout with
+ *        its phase times, edges solved per second (excluding parsing) and peak resident memory.
+ *
+ * @return terminate code
+ */
+int main(int argc, char *argv[]) {
+
+    vector<string> engines(begin(ENGINES), end(ENGINES)), inputs;
+    int warmup = 1, repeat = 5, workers = 0;
+    string format = "csv";
+
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--engines" && i + 1 < argc) {
+            engines.clear();
+            stringstream list(argv[++i]);
+            for (string engine; getline(list, engine, ','); ) {
+                if (find(begin(ENGINES), end(ENGINES), engine) == end(ENGINES)) printUsage();
+                engines.push_back(engine);
+            }
+        }
+        else if (option == "--warmup" && i + 1 < argc) warmup = atoi(argv[++i]);
+        else if (option == "--repeat" && i + 1 < argc) repeat = atoi(argv[++i]);
+        else if (option == "--workers" && i + 1 < argc) workers = atoi(argv[++i]);
+        else if (option == "--format" && i + 1 < argc) format = argv[++i];
+        else if (option.compare(0, 2, "--") == 0) printUsage();
+        else inputs.push_back(option);
+    }
+    if (inputs.empty() || repeat < 1 || warmup < 0 || (format != "csv" && format != "json"))
+        printUsage();
+
+    bool json = format == "json", first = true;
+    if (json) cout << "[" << endl;
+    else cout << "input,nodes,edges,engine,run,parse_s,order_s,path_s,total_s,edges_per_s,"
+              << "peak_rss_kb,interventions,sequence" << endl;
+
+    bool failed = false;
+    for (const string& input : inputs) {
+        for (const string& engine : engines) {
+
+            for (int run = -warmup; run < repeat; run++) {
+
+                benchmarkRunStruct measured;
+                long peakRss = 0;
+                if (!forkRun(input, engine, workers, measured, peakRss)) {
+                    cerr << input << ": " << engine << " run failed" << endl;
+                    failed = true;
+                    break;
+                }
+                if (run < 0) continue;
+
+                double total = measured.parse + measured.order + measured.path;
+                double solve = measured.order + measured.path;
+                double edgesPerSecond = solve > 0 ? measured.edges / solve : 0;
+
+                if (json) {
+                    cout << (first ? "" : ",\n") << "  {\"input\": \"" << input << "\", \"nodes\": "
+                         << measured.nodes << ", \"edges\": " << measured.edges
+                         << ", \"engine\": \"" << engine << "\", \"run\": " << run
+                         << ", \"parse_s\": " << measured.parse << ", \"order_s\": " << measured.order
+                         << ", \"path_s\": " << measured.path << ", \"total_s\": " << total
+                         << ", \"edges_per_s\": " << edgesPerSecond << ", \"peak_rss_kb\": " << peakRss
+                         << ", \"interventions\": " << measured.result.interventions
+                         << ", \"sequence\": " << measured.result.sequence << "}";
+                } else {
+                    cout << input << "," << measured.nodes << "," << measured.edges << "," << engine
+                         << "," << run << "," << measured.parse << "," << measured.order << ","
+                         << measured.path << "," << total << "," << edgesPerSecond << "," << peakRss
+                         << "," << measured.result.interventions << "," << measured.result.sequence
+                         << endl;
+                }
+                first = false;
+
+            }
+
+        }
+    }
+
+    if (json) cout << (first ? "" : "\n") << "]" << endl;
+
+    exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+
+}
@@ -0,0 +1,338 @@
+#include <cstring>
+#include "binaryGraph.h"
+#include "parallel.h"
+
+
+using namespace std;
+
+
+static_assert(sizeof(binaryHeaderStruct) == 64, "binary graph header must be 64 bytes long");
+static_assert(sizeof(size_t) == sizeof(uint64_t), "edge offsets are mapped as size_t");
+
+
+/**
+ * @brief Zeros used to pad every section up to a multiple of 8 bytes.
+ */
+static const char PADDING[8] = {0};
+
+
+/**
+ * @brief Holds where every section of a binary graph starts, in bytes from the header.
+ *
+ * @param edgeOffsets start of the edge offsets
+ * @param byteOffsets start of the byte offsets (compressed only)
+ * @param inDegrees start of the in degrees (optional)
+ * @param adjacency start of the adjacency
+ * @param size total size of the binary graph
+ */
+typedef struct binaryLayoutStruct {
+    uint64_t edgeOffsets;
+    uint64_t byteOffsets;
+    uint64_t inDegrees;
+    uint64_t adjacency;
+    uint64_t size;
+} binaryLayoutStruct;
+
+
+/**
+ * @brief Rounds a size up to the next multiple of 8.
+ *
+ * @param size size to be rounded
+ * @return rounded size
+ */
+static uint64_t align8(uint64_t size) { return (size + 7) & ~(uint64_t) 7; }
+
+
+/**
+ * @brief Computes where every section of a binary graph starts.
+ *
+ * @param header header of the binary graph
+ * @return layout of the binary graph
+ */
+static binaryLayoutStruct computeLayout(const binaryHeaderStruct& header) {
+
+    binaryLayoutStruct layout;
+    uint64_t offsetsSize = (header.nodes + 1) * sizeof(uint64_t);
+
+    layout.edgeOffsets = sizeof(binaryHeaderStruct);
+    layout.byteOffsets = layout.edgeOffsets + offsetsSize;
+    layout.inDegrees = layout.byteOffsets + (header.flags & BINARY_COMPRESSED ? offsetsSize : 0);
+    layout.adjacency = layout.inDegrees;
+    if (header.flags & BINARY_HAS_IN_DEGREES)
+        layout.adjacency += align8(header.nodes * sizeof(uint32_t));
+    layout.size = layout.adjacency + align8(header.adjacencyBytes);
+
+    return layout;
+
+}
+
+
+/**
+ * @brief Appends an unsigned value as a LEB128 varint (7 bits per byte, high bit set on every byte
+ *        but the last).
+ *
+ * @param value value to be encoded
+ * @param out buffer the bytes are appended to
+ */
+static void encodeVarint(uint32_t value, vector<uint8_t>& out) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t) (value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t) value);
+}
+
+
+/**
+ * @brief Decodes a LEB128 varint.
+ *
+ * @param cursor position of the varint's first byte. Moved past its last byte
+ * @param end position past the last byte that may be read
+ * @param value where the decoded value is stored
+ * @return true if the varint was complete and fits in 32 bits
+ */
+static bool decodeVarint(const uint8_t*& cursor, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && cursor != end; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= (uint32_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Writes a block of bytes followed by the zeros needed to keep the next section aligned.
+ *
+ * @param out stream the bytes are written to
+ * @param data bytes to be written
+ * @param size number of bytes
+ */
+static void writeAligned(ostream& out, const void* data, uint64_t size) {
+    out.write(static_cast<const char*>(data), size);
+    out.write(PADDING, align8(size) - size);
+}
+
+
+/**
+ * @brief Checks whether an input holds a binary graph instead of a text edge list.
+ *
+ * @param begin pointer to the first byte of the input
+ * @param end pointer past the last byte of the input
+ * @return true if the input starts with BINARY_GRAPH_MAGIC
+ */
+bool isBinaryGraph(const char* begin, const char* end) {
+    return end - begin >= 8 && memcmp(begin, BINARY_GRAPH_MAGIC, 8) == 0;
+}
+
+
+/**
+ * @brief Writes a graph in the binary layout.
+ *
+ * @param graph graph to be written. Its adjacency must be built
+ * @param out stream the graph is written to
+ * @param flags BINARY_HAS_IN_DEGREES and/or BINARY_COMPRESSED
+ * @return true if every byte was written
+ */
+bool writeBinaryGraph(const Graph& graph, ostream& out, unsigned flags) {
+
+    int nodes = graph.getNumberOfNodes();
+
+    /* Edge offsets are the running sum of every node's out degree */
+    vector<uint64_t> edgeOffsets(nodes + 1, 0);
+    for (int node = 1; node <= nodes; node++)
+        edgeOffsets[node] = edgeOffsets[node-1] + graph.getAdjacentNodes(node).size();
+
+    /* Compressed adjacencies sort every node's children so that the gaps between them are small */
+    vector<uint8_t> compressed;
+    vector<uint64_t> byteOffsets;
+    if (flags & BINARY_COMPRESSED) {
+        vector<int> children;
+        byteOffsets.assign(nodes + 1, 0);
+        for (int node = 1; node <= nodes; node++) {
+            adjacencyViewStruct adjacent = graph.getAdjacentNodes(node);
+            children.assign(adjacent.begin(), adjacent.end());
+            sort(children.begin(), children.end());
+            int previous = 0;
+            for (int child : children) {
+                encodeVarint((uint32_t) (child - previous), compressed);
+                previous = child;
+            }
+            byteOffsets[node] = compressed.size();
+        }
+    }
+
+    binaryHeaderStruct header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_GRAPH_MAGIC, 8);
+    header.version = BINARY_GRAPH_VERSION;
+    header.flags = flags & (BINARY_HAS_IN_DEGREES | BINARY_COMPRESSED);
+    header.nodes = nodes;
+    header.edges = edgeOffsets[nodes];
+    header.adjacencyBytes = flags & BINARY_COMPRESSED ? compressed.size()
+                                                      : header.edges * sizeof(int32_t);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeAligned(out, edgeOffsets.data(), edgeOffsets.size() * sizeof(uint64_t));
+    if (flags & BINARY_COMPRESSED)
+        writeAligned(out, byteOffsets.data(), byteOffsets.size() * sizeof(uint64_t));
+
+    if (flags & BINARY_HAS_IN_DEGREES) {
+        vector<uint32_t> inDegrees(nodes);
+        for (int node = 1; node <= nodes; node++) inDegrees[node-1] = graph.getNodeInDegree(node);
+        writeAligned(out, inDegrees.data(), inDegrees.size() * sizeof(uint32_t));
+    }
+
+    /* Uncompressed children are written node by node, which is exactly the layout in memory */
+    if (flags & BINARY_COMPRESSED) {
+        writeAligned(out, compressed.data(), compressed.size());
+    } else {
+        for (int node = 1; node <= nodes; node++) {
+            adjacencyViewStruct adjacent = graph.getAdjacentNodes(node);
+            out.write(reinterpret_cast<const char*>(adjacent.begin()), adjacent.size() * sizeof(int));
+        }
+        out.write(PADDING, align8(header.adjacencyBytes) - header.adjacencyBytes);
+    }
+
+    out.flush();
+    return (bool) out;
+
+}
+
+
+/**
+ * @brief Builds a graph from a binary graph held in memory. Uncompressed adjacencies are checked
+ *        and then used in place, without being copied, so the memory is kept alive by the graph.
+ *        Stored in degrees must match the ones counted from the children.
+ *
+ * @param input memory holding the binary graph
+ * @param begin pointer to the first byte of the binary graph
+ * @param end pointer past the last byte of the binary graph
+ * @param error description of what is wrong with the input, when it is malformed
+ * @return newly created graph, or nullptr if the input is malformed
+ */
+unique_ptr<Graph> loadBinaryGraph(shared_ptr<const void> input, const char* begin, const char* end,
+                                  string& error) {
+
+    binaryHeaderStruct header;
+    if (!isBinaryGraph(begin, end) || (size_t) (end - begin) < sizeof(header)) {
+        error = "binary graph: truncated header";
+        return nullptr;
+    }
+    memcpy(&header, begin, sizeof(header));
+
+    if (header.version != BINARY_GRAPH_VERSION) {
+        error = "binary graph: unsupported version " + to_string(header.version);
+        return nullptr;
+    }
+    /* Every edge takes at least one byte, which keeps the layout below from overflowing */
+    uint64_t size = end - begin;
+    if (header.nodes > INT_MAX || header.edges > size || header.adjacencyBytes > size) {
+        error = "binary graph: header does not fit in " + to_string(size) + " bytes";
+        return nullptr;
+    }
+
+    binaryLayoutStruct layout = computeLayout(header);
+    if (size < layout.size) {
+        error = "binary graph: expected " + to_string(layout.size) + " bytes, found " +
+                to_string(size);
+        return nullptr;
+    }
+
+    int nodes = (int) header.nodes;
+    const uint64_t* edgeOffsets = reinterpret_cast<const uint64_t*>(begin + layout.edgeOffsets);
+    const uint64_t* byteOffsets = reinterpret_cast<const uint64_t*>(begin + layout.byteOffsets);
+
+    /* Offsets are cheap to check and a bad one would make every view point anywhere */
+    bool compressed = header.flags & BINARY_COMPRESSED;
+    for (int node = 1; node <= nodes; node++) {
+        if (edgeOffsets[node] < edgeOffsets[node-1] ||
+            (compressed && byteOffsets[node] < byteOffsets[node-1])) {
+            error = "binary graph: offsets of node " + to_string(node) + " are decreasing";
+            return nullptr;
+        }
+    }
+    if (edgeOffsets[0] != 0 || edgeOffsets[nodes] != header.edges ||
+        (compressed && (byteOffsets[0] != 0 || byteOffsets[nodes] != header.adjacencyBytes)) ||
+        (!compressed && header.adjacencyBytes != header.edges * sizeof(int32_t))) {
+        error = "binary graph: offsets do not match the header";
+        return nullptr;
+    }
+
+    unique_ptr<Graph> graph(new Graph(nodes, header.edges));
+
+    if (!compressed) {
+
+        /* The children are used right where they are, so a bad one would be followed anywhere */
+        const int32_t* targets = reinterpret_cast<const int32_t*>(begin + layout.adjacency);
+        for (int node = 1; node <= nodes; node++) {
+            for (uint64_t edge = edgeOffsets[node-1]; edge < edgeOffsets[node]; edge++) {
+                if (targets[edge] < 1 || targets[edge] > nodes) {
+                    error = "binary graph: children of node " + to_string(node) + " are malformed";
+                    return nullptr;
+                }
+            }
+        }
+        graph->attachAdjacency(reinterpret_cast<const size_t*>(edgeOffsets),
+                               reinterpret_cast<const int*>(begin + layout.adjacency), input);
+
+    } else {
+
+        /* Every node's varints can be found on their own, so they are decoded by several workers */
+        for (int node = 1; node <= nodes; node++)
+            graph->addNodeDegrees(node, edgeOffsets[node] - edgeOffsets[node-1], 0);
+        graph->allocateAdjacency();
+
+        const uint8_t* adjacency = reinterpret_cast<const uint8_t*>(begin + layout.adjacency);
+        int workers = (int) min((uint64_t) getDefaultWorkers(), header.edges / (1 << 20) + 1);
+        vector<int> failed(workers, 0);
+        runWorkers(workers, [&](int worker) {
+            int first = (int) ((long long) nodes * worker / workers) + 1;
+            int last = (int) ((long long) nodes * (worker + 1) / workers);
+            for (int node = first; node <= last && !failed[worker]; node++) {
+                const uint8_t* cursor = adjacency + byteOffsets[node-1];
+                const uint8_t* stop = adjacency + byteOffsets[node];
+                size_t position = graph->getAdjacencyStart(node);
+                uint32_t child = 0, delta = 0;
+                for (uint64_t edge = edgeOffsets[node-1]; edge < edgeOffsets[node]; edge++) {
+                    if (!decodeVarint(cursor, stop, delta) || (child += delta) > (uint32_t) nodes ||
+                        child == 0) {
+                        failed[worker] = node;
+                        break;
+                    }
+                    graph->placeEdgeAt(position++, (int) child);
+                }
+            }
+        });
+        graph->finishAdjacency();
+
+        for (int node : failed) {
+            if (node != 0) {
+                error = "binary graph: children of node " + to_string(node) + " are malformed";
+                return nullptr;
+            }
+        }
+
+    }
+
+    /* In degrees are counted from the children, which were just checked. Stored ones must match
+     * them node by node, as the solvers sorting by in degrees would follow a wrong one */
+    for (int node = 1; node <= nodes; node++)
+        for (int child : graph->getAdjacentNodes(node))
+            graph->incrementNodeInDegree(child);
+    if (header.flags & BINARY_HAS_IN_DEGREES) {
+        const uint32_t* inDegrees = reinterpret_cast<const uint32_t*>(begin + layout.inDegrees);
+        for (int node = 1; node <= nodes; node++) {
+            if (inDegrees[node-1] != (uint32_t) graph->getNodeInDegree(node)) {
+                error = "binary graph: in degree of node " + to_string(node) + " is " +
+                        to_string(inDegrees[node-1]) + ", expected " +
+                        to_string(graph->getNodeInDegree(node));
+                return nullptr;
+            }
+        }
+    }
+
+    return graph;
+
+}
@@ -0,0 +1,99 @@
+#ifndef BINARY_GRAPH_H
+#define BINARY_GRAPH_H
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief First bytes of every binary graph. Used to tell it apart from a text edge list.
+ */
+#define BINARY_GRAPH_MAGIC "DOMGRAPH"
+
+/**
+ * @brief Version of the binary graph layout written by this code.
+ */
+#define BINARY_GRAPH_VERSION 1
+
+/**
+ * @brief Flag set when the file holds every node's in degree.
+ */
+#define BINARY_HAS_IN_DEGREES 1u
+
+/**
+ * @brief Flag set when each node's children are sorted and stored as varint encoded deltas.
+ */
+#define BINARY_COMPRESSED 2u
+
+
+/**
+ * @brief Fixed size header at the start of a binary graph. Every section after it starts at a
+ *        multiple of 8 bytes, in this order:
+ *        - edge offsets: nodes + 1 uint64, node n's children are edges [offset[n-1], offset[n])
+ *        - byte offsets (compressed only): nodes + 1 uint64, where each node's varints start
+ *        - in degrees (optional): nodes uint32
+ *        - adjacency: edges int32 children, or adjacencyBytes of varint deltas when compressed
+ *        Every value is stored little endian.
+ *
+ * @param magic holds BINARY_GRAPH_MAGIC
+ * @param version holds BINARY_GRAPH_VERSION
+ * @param flags holds BINARY_HAS_IN_DEGREES and BINARY_COMPRESSED
+ * @param nodes number of nodes
+ * @param edges number of edges
+ * @param adjacencyBytes size of the adjacency section
+ * @param reserved always zero
+ */
+typedef struct binaryHeaderStruct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t nodes;
+    uint64_t edges;
+    uint64_t adjacencyBytes;
+    uint64_t reserved[3];
+} binaryHeaderStruct;
+
+
+/**
+ * @brief Checks whether an input holds a binary graph instead of a text edge list.
+ *
+ * @param begin pointer to the first byte of the input
+ * @param end pointer past the last byte of the input
+ * @return true if the input starts with BINARY_GRAPH_MAGIC
+ */
+bool isBinaryGraph(const char* begin, const char* end);
+
+
+/**
+ * @brief Writes a graph in the binary layout.
+ *
+ * @param graph graph to be written. Its adjacency must be built
+ * @param out stream the graph is written to
+ * @param flags BINARY_HAS_IN_DEGREES and/or BINARY_COMPRESSED
+ * @return true if every byte was written
+ */
+bool writeBinaryGraph(const Graph& graph, ostream& out, unsigned flags);
+
+
+/**
+ * @brief Builds a graph from a binary graph held in memory. Uncompressed adjacencies are checked
+ *        and then used in place, without being copied, so the memory is kept alive by the graph.
+ *        Stored in degrees must match the ones counted from the children.
+ *
+ * @param input memory holding the binary graph
+ * @param begin pointer to the first byte of the binary graph
+ * @param end pointer past the last byte of the binary graph
+ * @param error description of what is wrong with the input, when it is malformed
+ * @return newly created graph, or nullptr if the input is malformed
+ */
+unique_ptr<Graph> loadBinaryGraph(shared_ptr<const void> input, const char* begin, const char* end,
+                                  string& error);
+
+
+#endif // BINARY_GRAPH_H
@@ -0,0 +1,68 @@
+#include "componentSolver.h"
+#include "stats.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Solves the domino problem on graphs that may have cycles. Pieces toppling each other in a
+ *        loop all fall together, so the strongly connected components are found with an iterative
+ *        Tarjan and the graph is condensed into a DAG of components, each weighted by its size. The
+ *        interventions are the components no other one reaches and the longest sequence is the
+ *        heaviest path of components. Every node's distance is left as its component's one.
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct solveWithComponents(Graph* graph) {
+
+    componentsStruct components = graph->components();
+    int count = components.start.size() - 1;
+
+    /* Every node's distance holds the heaviest sequence reaching it from other components, until
+     * its own component is solved and it takes that component's one */
+    for (int node = 1; node <= graph->getNumberOfNodes(); node++) graph->setNodeDistance(node, 0);
+
+    dominoResultStruct result = {0, 0};
+
+    /* Components are relaxed in topological order, that is the reverse of how they were closed */
+    for (int id = count - 1; id >= 0; id--) {
+
+        int first = components.start[id], last = components.start[id+1], size = last - first;
+
+        /* Nothing reaching any of its nodes from outside means it has to be pushed */
+        int dist = 0;
+        for (int i = first; i < last; i++)
+            dist = max(dist, graph->getNodeDistance(components.members[i]));
+        if (dist == 0) result.interventions++;
+        dist += size;
+        result.sequence = max(result.sequence, dist);
+
+        for (int i = first; i < last; i++) {
+
+            int node = components.members[i];
+            graph->setNodeDistance(node, dist);
+
+            adjacencyViewStruct children = graph->getAdjacentNodes(node);
+            STATS_ADD(edgesRelaxed, children.size());
+
+            /* Edges inside the component are skipped. A single node only has itself in there */
+            for (int child : children) {
+                if (size == 1 ? child == node : components.component[child-1] == id) continue;
+                if (graph->getNodeDistance(child) < dist) {
+                    graph->setNodeDistance(child, dist);
+                    STATS_ADD(distanceUpdates, 1);
+                }
+            }
+
+        }
+
+    }
+
+    /* Like the other solvers, the sequence only counts once some piece was toppled by another one */
+    if (result.sequence < 2) result.sequence = 0;
+
+    return result;
+
+}
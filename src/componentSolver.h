@@ -0,0 +1,23 @@
+#ifndef COMPONENT_SOLVER_H
+#define COMPONENT_SOLVER_H
+
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Solves the domino problem on graphs that may have cycles. Pieces toppling each other in a
+ *        loop all fall together, so the strongly connected components are found with an iterative
+ *        Tarjan and the graph is condensed into a DAG of components, each weighted by its size. The
+ *        interventions are the components no other one reaches and the longest sequence is the
+ *        heaviest path of components. Every node's distance is left as its component's one.
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct solveWithComponents(Graph* graph);
+
+
+#endif // COMPONENT_SOLVER_H
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "binaryGraph.h"
+#include "reader.h"
+#include "reduction.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Prints how to use this program and terminates it.
+ */
+void printUsage() {
+    cerr << "Usage: convert-graph [--compress] [--no-in-degrees] [--reduce [--window N]]"
+         << " < edges.txt > graph.bin" << endl;
+    cerr << "\t--compress: stores every node's sorted children as varint encoded deltas" << endl;
+    cerr << "\t--no-in-degrees: leaves in degrees out, they are counted when loading" << endl;
+    cerr << "\t--reduce: stores the transitive reduction, so every later solve reads fewer edges"
+         << endl;
+    cerr << "\t--window N: with --reduce, only drops edges whose parent is at most N positions"
+         << " before its child's block, which bounds the time on large sparse inputs" << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/**
+ * @brief Driver code. Converts a text edge list read from stdin to a binary graph on stdout.
+ *
+ * @return terminate code
+ */
+int main(int argc, char *argv[]) {
+
+    /* In degrees are kept by default, so loading does not need to touch every edge */
+    unsigned flags = BINARY_HAS_IN_DEGREES;
+    bool reduce = false;
+    size_t window = 0;
+
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--compress") flags |= BINARY_COMPRESSED;
+        else if (option == "--no-in-degrees") flags &= ~BINARY_HAS_IN_DEGREES;
+        else if (option == "--reduce") reduce = true;
+        else if (option == "--window" && i + 1 < argc) window = strtoull(argv[++i], nullptr, 10);
+        else printUsage();
+    }
+
+    if (window > 0 && !reduce) printUsage();
+    if (isatty(STDOUT_FILENO)) printUsage();
+
+    Graph graph = readGraph(STDIN_FILENO);
+
+    /* Reducing once is paid back by every solve of the stored graph. Cycles are stored as read */
+    if (reduce) {
+        size_t pruned, edges = graph.getNumberOfEdges();
+        if (reduceTransitiveEdges(&graph, &pruned, window))
+            cerr << "pruned edges: " << pruned << " of " << edges << endl;
+        else cerr << "not reduced: the pieces are placed with cycles" << endl;
+    }
+
+    if (!writeBinaryGraph(graph, cout, flags)) {
+        cerr << "could not write binary graph" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
@@ -1,12 +1,99 @@
 #include <iostream>
 #include <vector>
 #include <deque>
+#include <string>
+#include <utility>
+#include <climits>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <immintrin.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 #define NEGATIVE_INFINITY -100
+#define READ_BLOCK_SIZE (1 << 22)
+#define BINARY_GRAPH_MAGIC "DOMGRAPH"
+#define BINARY_GRAPH_VERSION 1
+#define BINARY_HAS_IN_DEGREES 1u
+#define BINARY_COMPRESSED 2u
 using namespace std;
 
 
+/**
+ * @brief Counters of the solvers' hot paths. They are only updated when built with -DDOMINO_STATS,
+ *        otherwise STATS_ADD expands to nothing and the hot paths are exactly as without them.
+ *
+ * @param edgesRelaxed edges walked while finding the longest path
+ * @param distanceUpdates distances that actually grew while relaxing those edges
+ * @param dfsPushes frames pushed on the DFS auxiliary stack
+ * @param dfsVisits nodes closed by the DFS, each exactly once
+ * @param allocations calls to operator new
+ * @param allocatedBytes bytes asked to operator new
+ */
+typedef struct solverStatsStruct {
+    atomic<uint64_t> edgesRelaxed;
+    atomic<uint64_t> distanceUpdates;
+    atomic<uint64_t> dfsPushes;
+    atomic<uint64_t> dfsVisits;
+    atomic<uint64_t> allocations;
+    atomic<uint64_t> allocatedBytes;
+} solverStatsStruct;
+
+
+/**
+ * @brief Counters of the whole program. Zero initialized before main runs.
+ */
+solverStatsStruct solverStats;
+
+
+/**
+ * @brief Adds an amount to one of solverStats' counters, or nothing unless built with -DDOMINO_STATS.
+ *        Hot loops should add their local totals once instead of counting every step. Without the
+ *        counters the amount is not even evaluated, so it may be a local only kept for them.
+ */
+#ifdef DOMINO_STATS
+#define STATS_ADD(counter, amount) solverStats.counter.fetch_add(amount, memory_order_relaxed)
+#else
+#define STATS_ADD(counter, amount) ((void) sizeof(amount))
+#endif
+
+
+#ifdef DOMINO_STATS
+
+/**
+ * @brief Counts every allocation made through new before handing it to malloc.
+ *
+ * @param size number of bytes asked
+ * @return allocated memory
+ */
+void* operator new(size_t size) {
+    STATS_ADD(allocations, 1);
+    STATS_ADD(allocatedBytes, size);
+    void* memory = malloc(size ? size : 1);
+    if (memory == nullptr) throw bad_alloc();
+    return memory;
+}
+
+
+/**
+ * @brief Gives memory taken by the counting operator new back to malloc. Kept out of line, as the
+ *        compiler would otherwise see free() right after operator new and warn about a mismatch.
+ *
+ * @param memory memory to be released
+ */
+__attribute__((noinline)) void operator delete(void* memory) noexcept { free(memory); }
+
+#endif
+
+
 /**
  * @brief Represents a node's color. Used mainly during DFS.
  *
@@ -18,26 +105,167 @@ enum class Color { white, black, grey };
 
 
 /**
- * @brief Holds information about the related node.
+ * @brief Node state kept as one array per field (struct of arrays), so loops touching one field
+ *        only bring that field into cache. Colors take 2 bits each, packed 32 to a word, and in
+ *        degrees take 16 bits whenever the graph cannot have more than 65535 edges. Nodes are
+ *        given by their position (node - 1).
+ */
+class PackedNodeState {
+
+    private:
+
+        /**
+         * @brief Holds every node's color, 2 bits each. Node i uses bits 2 * (i % 32) onwards of
+         *        word i / 32. Words are written whole, so two threads may not set colors of nodes
+         *        sharing a word at once.
+         */
+        vector<uint64_t> _colors;
+
+        /**
+         * @brief Holds every node's in degree when they all fit in 16 bits.
+         */
+        vector<uint16_t> _narrowInDegrees;
+
+        /**
+         * @brief Holds every node's in degree otherwise.
+         */
+        vector<uint32_t> _wideInDegrees;
+
+        /**
+         * @brief Holds every node's distance.
+         */
+        vector<int> _dist;
+
+        /**
+         * @brief Holds whether in degrees are kept in _wideInDegrees.
+         */
+        bool _wide;
+
+    public:
+
+        /**
+         * @brief PackedNodeState constructor. Every node starts white, with no parents and
+         *        distance 1.
+         *
+         * @param nodes number of nodes
+         * @param edges upper bound on the number of edges, which bounds every in degree
+         */
+        PackedNodeState(int nodes, size_t edges) { this->reset(nodes, edges); };
+
+        /**
+         * @brief Brings every node back to its initial state, keeping the memory already held. The
+         *        in degree width is chosen again from the new bound.
+         *
+         * @param nodes number of nodes
+         * @param edges upper bound on the number of edges, which bounds every in degree
+         */
+        void reset(int nodes, size_t edges) {
+            this->_colors.assign(((size_t) nodes + 31) / 32, 0);
+            this->_dist.assign(nodes, 1);
+            this->_wide = edges > UINT16_MAX;
+            if (this->_wide) this->_wideInDegrees.assign(nodes, 0);
+            else this->_narrowInDegrees.assign(nodes, 0);
+        };
+
+        Color getColor(int index) const {
+            return (Color) ((this->_colors[index >> 5] >> ((index & 31) * 2)) & 3);
+        };
+
+        int getInDegree(int index) const {
+            return this->_wide ? this->_wideInDegrees[index] : this->_narrowInDegrees[index];
+        };
+
+        int getDistance(int index) const { return this->_dist[index]; };
+        int* getDistances() { return this->_dist.data(); };
+
+        void setColor(int index, Color color) {
+            int shift = (index & 31) * 2;
+            uint64_t& word = this->_colors[index >> 5];
+            word = (word & ~((uint64_t) 3 << shift)) | ((uint64_t) color << shift);
+        };
+
+        void setInDegree(int index, int inDegree) {
+            if (this->_wide) this->_wideInDegrees[index] = inDegree;
+            else this->_narrowInDegrees[index] = inDegree;
+        };
+
+        void setDistance(int index, int dist) { this->_dist[index] = dist; };
+
+};
+
+
+/**
+ * @brief Read-only view over a node's children inside the contiguous adjacency. Can be walked with a
+ *        range based for loop without copying anything.
+ *
+ * @param first pointer to the first child
+ * @param last pointer past the last child
+ */
+typedef struct adjacencyViewStruct {
+    const int* first;
+    const int* last;
+    adjacencyViewStruct(const int* first, const int* last) : first(first), last(last) {};
+    const int* begin() const { return first; };
+    const int* end() const { return last; };
+    size_t size() const { return last - first; };
+    bool empty() const { return first == last; };
+} adjacencyViewStruct;
+
+
+/**
+ * @brief Holds a node being visited by the DFS together with the next child to look at.
+ *
+ * @param node node being visited
+ * @param next next child to look at
+ * @param last pointer past the node's last child
+ */
+typedef struct dfsFrameStruct {
+    int node;
+    const int* next;
+    const int* last;
+    dfsFrameStruct(int node, adjacencyViewStruct children)
+        : node(node), next(children.begin()), last(children.end()) {};
+} dfsFrameStruct;
+
+
+/**
+ * @brief Holds a node being visited by Graph::components() together with the index it was
+ *        discovered with and the smallest index it reaches (its low link).
  *
- * @param color represents the current state of the node
- * @param inDegree holds the amount of nodes connected to this node
- * @param dist holds distance to another Source
+ * @param node node being visited
+ * @param index index the node was discovered with
+ * @param low smallest index of a node in an open component reached from this one
+ * @param next next child to look at
+ * @param last pointer past the node's last child
  */
-typedef struct nodeInfoStruct {
-    Color color;
-    int inDegree;
-    int dist;
-    nodeInfoStruct() {
-        color = Color::white;
-        inDegree = 0;
-        dist = 1;
-    };
-} nodeInfoStruct;
+typedef struct componentFrameStruct {
+    int node;
+    int index;
+    int low;
+    const int* next;
+    const int* last;
+    componentFrameStruct(int node, int index, adjacencyViewStruct children)
+        : node(node), index(index), low(index), next(children.begin()), last(children.end()) {};
+} componentFrameStruct;
 
 
 /**
- * @brief Represents a Directed Acyclic Graph. Uses adjacency list.
+ * @brief Holds the strongly connected components of a graph.
+ *
+ * @param members nodes grouped by component, components in reverse topological order
+ * @param start position in members where each component starts, plus the end of the last one
+ * @param component every node's component, given by its position in start
+ */
+typedef struct componentsStruct {
+    vector<int> members;
+    vector<int> start;
+    vector<int> component;
+} componentsStruct;
+
+
+/**
+ * @brief Represents a Directed Acyclic Graph. Uses a Compressed Sparse Row (CSR) adjacency: one
+ *        offsets array plus one contiguous array with every node's children.
  */
 class Graph {
 
@@ -46,12 +274,36 @@ class Graph {
         /**
          * @brief Holds all the info related to the key node after DFS traversal.
          */
-        vector<nodeInfoStruct> _nodeInfo;
+        PackedNodeState _nodeInfo;
+
+        /**
+         * @brief Holds where each node's children start inside _targets. Node n's children live in
+         *        [_offsets[n-1], _offsets[n]). While edges are still being added, _offsets[n] holds
+         *        node n's out degree instead.
+         */
+        vector<size_t> _offsets;
+
+        /**
+         * @brief Holds all the nodes which each node leads to, stored contiguously per parent.
+         */
+        vector<int> _targets;
+
+        /**
+         * @brief Points to the children actually used by the adjacency accessors. It is either
+         *        _targets' memory or external memory kept alive by _external.
+         */
+        const int* _adjacency;
+
+        /**
+         * @brief Keeps external adjacency memory (e.g. a mapped binary graph) alive while in use.
+         */
+        shared_ptr<const void> _external;
 
         /**
-         * @brief Holds all the nodes which this node leads to.
+         * @brief Holds the next free position inside _targets of each node while the adjacency is
+         *        being filled. Only allocated between allocateAdjacency and the last placeEdge.
          */
-        vector<vector<int>> _adjacent;
+        vector<size_t> _cursor;
 
         /**
          * @brief Holds number of vertices inside this graph.
@@ -63,21 +315,55 @@ class Graph {
          */
         int _interventions;
 
+        /**
+         * @brief Holds the most frames the last dfs() ever held at once.
+         */
+        size_t _peakDfsAuxSize;
+
+        /**
+         * @brief Holds whether the last traversal found the pieces' placement to have a cycle.
+         */
+        bool _hasCycle;
+
     public:
 
         /**
          * @brief Graph constructor.
          *
          * @param nodes number of nodes inside graph
+         * @param edges upper bound on the number of edges, used to size the in degrees
+         */
+        explicit Graph(int nodes, size_t edges = INT_MAX) : _nodeInfo(0, 0) {
+            this->reset(nodes, edges);
+        };
+
+        /**
+         * @brief Graphs own large buffers, so they can only be moved around, never copied.
+         */
+        Graph(Graph&&) = default;
+        Graph& operator=(Graph&&) = default;
+        Graph(const Graph&) = delete;
+        Graph& operator=(const Graph&) = delete;
+
+        /**
+         * @brief Empties this graph and gives it a new number of nodes, as if it had just been
+         *        constructed, but keeping every buffer's memory so that many graphs of similar size
+         *        can be built one after the other without allocating again.
+         *
+         * @param nodes number of nodes inside graph
+         * @param edges upper bound on the number of edges, used to size the in degrees
          */
-        explicit Graph(int nodes) {
+        void reset(int nodes, size_t edges = INT_MAX) {
 
-            /* Populates info vector with all the possible nodes */
-            nodeInfoStruct info;
-            this->_nodeInfo.resize(nodes, info);
+            this->_nodeInfo.reset(nodes, edges);
 
-            /* Creates and allocates space for all the nodes' connections */
-            this->_adjacent.resize(nodes);
+            /* Creates space for every node's out degree (later turned into offsets). Node n uses
+             * position n so that position 0 stays as the start of the first node */
+            this->_offsets.assign(nodes + 1, 0);
+            this->_targets.clear();
+            this->_adjacency = this->_targets.data();
+            this->_external.reset();
+            this->_cursor.clear();
 
             /* Saves number of nodes */
             this->_numberOfNodes = nodes;
@@ -86,24 +372,54 @@ class Graph {
              * and each time we add a new edge that increments a node's in degree, we decrease this
              * value */
             this->_interventions = nodes;
+            this->_peakDfsAuxSize = 0;
+            this->_hasCycle = false;
 
         };
 
         /**
-         * @brief Get the Node Info object.
+         * @brief Get the Node Color object.
          *
          * @param node node value
-         * @return nodeInfoStruct related to this node
+         * @return node's current color
          */
-        nodeInfoStruct getNodeInfo(int node) { return this->_nodeInfo[node-1]; };
+        Color getNodeColor(int node) const { return this->_nodeInfo.getColor(node - 1); };
+
+        /**
+         * @brief Get the Node In Degree object.
+         *
+         * @param node node value
+         * @return number of edges leading to this node
+         */
+        int getNodeInDegree(int node) const { return this->_nodeInfo.getInDegree(node - 1); };
+
+        /**
+         * @brief Get the Node Distance object.
+         *
+         * @param node node value
+         * @return node's current distance
+         */
+        int getNodeDistance(int node) const { return this->_nodeInfo.getDistance(node - 1); };
+
+        /**
+         * @brief Get the Node Distances object. Lets vectorized loops read and write distances
+         *        directly.
+         *
+         * @return every node's distance, node n at position n - 1
+         */
+        int* getNodeDistances() { return this->_nodeInfo.getDistances(); };
 
         /**
          * @brief Get the Adjacent Nodes object.
          *
          * @param node node value
-         * @return vector<int> representing a list of connected nodes
+         * @return view over this node's children inside the contiguous adjacency
          */
-        vector<int> getAdjacentNodes(int node) { return this->_adjacent[node-1]; };
+        adjacencyViewStruct getAdjacentNodes(int node) const {
+            const int* targets = this->_adjacency;
+            return adjacencyViewStruct(targets + this->_offsets[node-1],
+                                       targets + this->_offsets[node]);
+        };
 
         /**
          * @brief Get the Number of Nodes object.
@@ -119,20 +435,36 @@ class Graph {
          */
         int getNumberOfInterventions() const { return this->_interventions; };
 
+        /**
+         * @brief Get the Peak Dfs Aux Size object.
+         *
+         * @return most frames the last dfs() ever held at once
+         */
+        size_t getPeakDfsAuxSize() const { return this->_peakDfsAuxSize; };
+
+        /**
+         * @brief Tells whether the last traversal found a cycle.
+         *
+         * @return true if some piece, directly or not, makes itself fall
+         */
+        bool hasCycle() const { return this->_hasCycle; };
+
         /**
          * @brief Changes node's current color.
          *
          * @param node node to be changed
          * @param color new color
          */
-        void setNodeColor(int node, Color color) { this->_nodeInfo[node-1].color = color; };
+        void setNodeColor(int node, Color color) { this->_nodeInfo.setColor(node - 1, color); };
 
         /**
          * @brief Increments node's total in degree value.
          *
          * @param node node to be changed
          */
-        void incrementNodeInDegree(int node) { this->_nodeInfo[node-1].inDegree++; };
+        void incrementNodeInDegree(int node) {
+            this->_nodeInfo.setInDegree(node - 1, this->_nodeInfo.getInDegree(node - 1) + 1);
+        };
 
         /**
          * @brief Increments node's total in degree value.
@@ -145,22 +477,23 @@ class Graph {
          * @param node node to be changed
          * @param dist new distance
          */
-        void setNodeDistance(int node, int dist) { this->_nodeInfo[node-1].dist = dist; };
+        void setNodeDistance(int node, int dist) { this->_nodeInfo.setDistance(node - 1, dist); };
 
         /**
-         * @brief Inserts a new edge from parent to child node.
+         * @brief First pass of a two pass construction. Counts an edge's out and in degrees
+         *        without keeping the edge itself, for callers that can replay their edge stream.
          *
          * @param parent parent's node
          * @param child child's node
          */
-        void addEdge(int parent, int child) {
+        void countEdge(int parent, int child) {
 
-            /* Creates a connection between two nodes */
-            this->_adjacent[parent-1].push_back(child);
+            /* Counts parent's out degree. It is turned into an offset by allocateAdjacency */
+            this->_offsets[parent]++;
 
             /* Increments child's in degrees and decrements number of interventions if it is the
              * first time this node is referenced. Also changes it's distance to infinity */
-            if (this->getNodeInfo(child).inDegree == 0) {
+            if (this->getNodeInDegree(child) == 0) {
                 this->decrementNumberInterventions();
                 this->setNodeDistance(child, NEGATIVE_INFINITY);
             }
@@ -168,51 +501,135 @@ class Graph {
 
         }
 
+        /**
+         * @brief Turns the counted out degrees into offsets and allocates the contiguous
+         *        adjacency. Must be called between the countEdge and placeEdge passes.
+         */
+        void allocateAdjacency() {
+
+            /* Turns out degrees into offsets. After this, node n's children end at _offsets[n] */
+            for (int node = 1; node <= this->getNumberOfNodes(); node++)
+                this->_offsets[node] += this->_offsets[node-1];
+
+            /* Every node starts filling its children at its own offset */
+            this->_cursor.assign(this->_offsets.begin(), this->_offsets.end() - 1);
+            this->_targets.resize(this->_offsets.back());
+            this->_adjacency = this->_targets.data();
+
+        }
+
+        /**
+         * @brief Second pass of a two pass construction. Places a previously counted edge right
+         *        after its parent's other children.
+         *
+         * @param parent parent's node
+         * @param child child's node
+         */
+        void placeEdge(int parent, int child) {
+            this->_targets[this->_cursor[parent-1]++] = child;
+        };
+
+        /**
+         * @brief Ends a two pass construction by releasing the memory used while filling.
+         */
+        void finishAdjacency() { vector<size_t>().swap(this->_cursor); };
+
+        /**
+         * @brief Counts many edges of a node at once, as countEdge would have done one by one.
+         *
+         * @param node node to be changed
+         * @param outDegree number of edges leaving this node
+         * @param inDegree number of edges reaching this node
+         */
+        void addNodeDegrees(int node, size_t outDegree, int inDegree) {
+
+            this->_offsets[node] += outDegree;
+
+            /* Same bookkeeping as countEdge when this node is reached for the first time */
+            if (inDegree > 0 && this->getNodeInDegree(node) == 0) {
+                this->decrementNumberInterventions();
+                this->setNodeDistance(node, NEGATIVE_INFINITY);
+            }
+            this->_nodeInfo.setInDegree(node - 1, this->getNodeInDegree(node) + inDegree);
+
+        }
+
+        /**
+         * @brief Uses an adjacency stored elsewhere instead of building one. The children are not
+         *        copied, so loading a graph costs only the pages actually touched.
+         *
+         * @param offsets nodes + 1 offsets, with the same meaning as after finishAdjacency
+         * @param targets every node's children, stored contiguously per parent
+         * @param owner keeps targets' memory alive while this graph uses it
+         */
+        void attachAdjacency(const size_t* offsets, const int* targets,
+                             shared_ptr<const void> owner) {
+            this->_offsets.assign(offsets, offsets + this->getNumberOfNodes() + 1);
+            vector<int>().swap(this->_targets);
+            this->_adjacency = targets;
+            this->_external = owner;
+        }
+
         /**
          * @brief Performs an iterative DFS traversal of this graph starting from first node (1).
+         *        Every node being visited keeps a frame with the next child to look at, so the
+         *        auxiliary stack never holds more than one frame per node. Reaching a grey node
+         *        (a back edge) marks the graph as cyclic, in which case the order is not valid.
          *
          * @return deque with nodes in topological order
          */
         deque<int> dfs() {
 
-            /* Holds nodes that we are visiting or are about to visit */
-            deque<int> dfsAux;
+            /* Holds a frame for every node that is being visited (grey), from the oldest to the
+             * newest. It mimics what a recursion would have done */
+            vector<dfsFrameStruct> dfsAux;
 
             /* Holds nodes that have been already visited in topological order */
             deque<int> topological;
 
+            this->_peakDfsAuxSize = 0;
+            this->_hasCycle = false;
+
             /* Visits each node (domino piece) in our graph */
             for (int parent = 1; parent <= this->getNumberOfNodes(); parent++) {
 
-                /* If it has not been yet visited, we put it inside our dfs aux */
-                if (this->getNodeInfo(parent).color == Color::white)
-                    dfsAux.push_front(parent);
+                /* If it has not been yet visited, we start visiting it */
+                if (this->getNodeColor(parent) != Color::white) continue;
+                this->setNodeColor(parent, Color::grey);
+                dfsAux.emplace_back(parent, this->getAdjacentNodes(parent));
+                this->_peakDfsAuxSize = max(this->_peakDfsAuxSize, dfsAux.size());
+                STATS_ADD(dfsPushes, 1);
 
-                /* We keep visiting node until all the nodes have turned black (fully visited) */
+                /* We keep visiting nodes until every node reached from parent has turned black */
                 while (!dfsAux.empty()) {
 
-                    /* Gets last node being put inside our auxiliary. It mimics what a recursion
-                     * would have done */
-                    int node = dfsAux.front();
+                    dfsFrameStruct& frame = dfsAux.back();
 
-                    /* If we have already visited everything from this node, we put it in our topological
-                     * stack and go to next iteration */
-                    if (this->getNodeInfo(node).color == Color::black) {
-                        dfsAux.pop_front();
-                        topological.push_front(node);
-                        continue;
+                    /* Skips children which have already been reached. A grey one is still being
+                     * visited, so it leads back to itself through this node */
+                    for (; frame.next != frame.last; frame.next++) {
+                        Color color = this->getNodeColor(*frame.next);
+                        if (color == Color::white) break;
+                        if (color == Color::grey) this->_hasCycle = true;
                     }
 
-                    /* Since we are about to visit each child from this node, we set it as grey */
-                    this->setNodeColor(node, Color::grey);
-
-                    /* Puts every not yet visited child node inside aux */
-                    for (int son : this->getAdjacentNodes(node))
-                        if(this->getNodeInfo(son).color == Color::white)
-                            dfsAux.push_front(son);
+                    /* If we have already visited everything from this node, it has finished and
+                     * goes into our topological stack */
+                    if (frame.next == frame.last) {
+                        this->setNodeColor(frame.node, Color::black);
+                        topological.push_front(frame.node);
+                        STATS_ADD(dfsVisits, 1);
+                        dfsAux.pop_back();
+                        continue;
+                    }
 
-                    /* Since we have put all it's children inside the aux, it has finished */
-                    this->setNodeColor(node, Color::black);
+                    /* Otherwise we go down into the next child. The frame reference is not used
+                     * after this since the push may move it */
+                    int son = *frame.next++;
+                    this->setNodeColor(son, Color::grey);
+                    dfsAux.emplace_back(son, this->getAdjacentNodes(son));
+                    this->_peakDfsAuxSize = max(this->_peakDfsAuxSize, dfsAux.size());
+                    STATS_ADD(dfsPushes, 1);
 
                 }
 
@@ -221,103 +638,1178 @@ class Graph {
             return topological;
         }
 
-};
-
-
-/**
- * @brief Creates and populates the graph that is going to represent all the pieces' placement.
- *
- * @return newly created graph
- */
-Graph initGraph() {
+        /**
+         * @brief Finds the strongly connected components with an iterative Tarjan, going through
+         *        the nodes as dfs() does. Every node is left black and, like dfs(), reaching a grey
+         *        node marks the graph as cyclic.
+         *
+         * @return every component's nodes, closed components first (reverse topological order)
+         */
+        componentsStruct components() {
+
+            int nodes = this->getNumberOfNodes();
+            componentsStruct components;
+
+            /* Colors tell apart nodes not reached yet (white), in a component still open (grey)
+             * and in a closed one (black), so most edges only look at the packed colors. Grey
+             * nodes keep the index they were discovered with, which black ones swap for their
+             * component */
+            vector<int>& index = components.component;
+            index.assign(nodes, 0);
+            for (int node = 1; node <= nodes; node++) this->setNodeColor(node, Color::white);
+
+            /* Holds the frames of the nodes being visited, as dfs() does, and the visited nodes
+             * waiting for their component to close */
+            vector<componentFrameStruct> frames;
+            vector<int> waiting;
+
+            components.members.reserve(nodes);
+            components.start.reserve(nodes + 1);
+
+            this->_peakDfsAuxSize = 0;
+            this->_hasCycle = false;
+            int discovered = 0;
+
+            for (int root = 1; root <= nodes; root++) {
+
+                if (this->getNodeColor(root) != Color::white) continue;
+                this->setNodeColor(root, Color::grey);
+                index[root-1] = ++discovered;
+                frames.emplace_back(root, discovered, this->getAdjacentNodes(root));
+                this->_peakDfsAuxSize = max(this->_peakDfsAuxSize, frames.size());
+                STATS_ADD(dfsPushes, 1);
+
+                while (!frames.empty()) {
+
+                    componentFrameStruct& frame = frames.back();
+
+                    /* Skips children which have already been reached. A grey one belongs to this
+                     * node's component, which is therefore a cycle, and may lower the low link */
+                    for (; frame.next != frame.last; frame.next++) {
+                        int child = *frame.next;
+                        Color color = this->getNodeColor(child);
+                        if (color == Color::white) break;
+                        if (color == Color::grey) {
+                            this->_hasCycle = true;
+                            frame.low = min(frame.low, index[child-1]);
+                        }
+                    }
 
-    /* Receive number of nodes and vertices from cin */
-    int nNodes = 0, nEdges = 0;
+                    /* Goes down into the next child. The frame reference is not used after this
+                     * since the push may move it */
+                    if (frame.next != frame.last) {
+                        int child = *frame.next++;
+                        this->setNodeColor(child, Color::grey);
+                        index[child-1] = ++discovered;
+                        frames.emplace_back(child, discovered, this->getAdjacentNodes(child));
+                        this->_peakDfsAuxSize = max(this->_peakDfsAuxSize, frames.size());
+                        STATS_ADD(dfsPushes, 1);
+                        continue;
+                    }
 
-    /* Hold parent and child node numbers while populating */
-    int parent = 0, child = 0;
+                    componentFrameStruct closed = frame;
+                    frames.pop_back();
+                    STATS_ADD(dfsVisits, 1);
+
+                    /* A node reaching nothing discovered before it closes a component with every
+                     * waiting node discovered after it. Otherwise it waits as well and its parent
+                     * reaches as far */
+                    if (closed.low == closed.index) {
+                        int id = components.start.size();
+                        components.start.push_back(components.members.size());
+                        while (!waiting.empty() && index[waiting.back()-1] > closed.index) {
+                            index[waiting.back()-1] = id;
+                            this->setNodeColor(waiting.back(), Color::black);
+                            components.members.push_back(waiting.back());
+                            waiting.pop_back();
+                        }
+                        index[closed.node-1] = id;
+                        this->setNodeColor(closed.node, Color::black);
+                        components.members.push_back(closed.node);
+                    } else {
+                        waiting.push_back(closed.node);
+                        frames.back().low = min(frames.back().low, closed.low);
+                    }
 
-    /* Reads number of nodes and edges from cin */
-    scanf("%d %d", &nNodes, &nEdges);
+                }
 
-    /* Creates graph */
-    Graph graph(nNodes);
+            }
 
-    /* Populates graph with all the edges from cin */
-    for (int i = 0; i < nEdges; i++) {
-        scanf("%d %d", &parent, &child);
-        graph.addEdge(parent, child);
-    }
+            components.start.push_back(components.members.size());
 
-    return graph;
+            return components;
+        }
 
-}
+};
 
 
 /**
- * @brief Counts number os times we have to make a piece fall to traverse all the pieces (is just
- *        the amount of node with in degree 0). Also finds longest path in our graph
- *
- * @param graph graph representing domino problem which will be traversed
- * @param topological stack with nodes in topological order
+ * @brief Holds the raw bytes of an edge list input. Regular files are mapped into memory and any
+ *        other input (pipes, terminals) is read in large blocks.
  */
-void solveDominoPiecesProblem(Graph* graph, deque<int>* topological) {
+class InputBuffer {
 
-    /* Holds the number of nodes traversed in the longest sequence of dominoes */
-    int sequence = 1;
+    private:
 
-    /* We traverse all the nodes in our topological stack and traverse them one by one. While doing
-     * this, we traverse their children and change their distance. This will count the number of
-     * edges between them and their parents */
-    while ( ! topological->empty()) {
+        /**
+         * @brief Holds the mapped file, or nullptr when the input was read into _block.
+         */
+        char* _mapped;
 
-        /* Gets node from stack */
-        int node = topological->front(); topological->pop_front();
+        /**
+         * @brief Holds the input when it could not be mapped.
+         */
+        vector<char> _block;
 
-        /* Traverses children sets their distance */
-        if (graph->getNodeInfo(node).dist != NEGATIVE_INFINITY) {
+        /**
+         * @brief Holds number of bytes in the input.
+         */
+        size_t _size;
 
-            int dist = graph->getNodeInfo(node).dist + 1;
+        /**
+         * @brief Holds a description of what went wrong while reading, empty if nothing did.
+         */
+        string _error;
 
-            for (int child: graph->getAdjacentNodes(node)) {
+    public:
 
-                if (graph->getNodeInfo(child).dist < dist) {
+        /**
+         * @brief InputBuffer constructor. Reads everything available from the file descriptor.
+         *
+         * @param fd file descriptor to read from
+         */
+        explicit InputBuffer(int fd) : _mapped(nullptr), _size(0) {
+
+            /* Regular files are mapped, so their pages are only brought in as they are parsed */
+            struct stat info;
+            if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+                void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+                    this->_mapped = static_cast<char*>(mapped);
+                    this->_size = info.st_size;
+                    return;
+                }
+            }
 
-                    graph->setNodeDistance(child, dist);
+            /* Anything else is read in large blocks until there is nothing left */
+            while (true) {
+                if (this->_block.size() < this->_size + READ_BLOCK_SIZE)
+                    this->_block.resize(max(this->_block.size() * 2, this->_size + READ_BLOCK_SIZE));
+                char* free = this->_block.data() + this->_size;
+                ssize_t bytes = read(fd, free, this->_block.size() - this->_size);
+                if (bytes == 0) break;
+                if (bytes < 0) {
+                    if (errno == EINTR) continue;
+                    this->_error = string("could not read input: ") + strerror(errno);
+                    break;
+                }
+                this->_size += bytes;
+            }
 
-                    /* Finds and holds longest distance. Is done here as to avoid doing another loop
-                     * to find the highest distance */
-                    if (dist > sequence) sequence = dist;
+        };
 
-                }
+        /**
+         * @brief InputBuffer destructor. Unmaps the input if it was mapped.
+         */
+        ~InputBuffer() { if (this->_mapped != nullptr) munmap(this->_mapped, this->_size); };
 
-            }
+        InputBuffer(const InputBuffer&) = delete;
+        InputBuffer& operator=(const InputBuffer&) = delete;
 
-        }
+        /**
+         * @brief Get the Begin object.
+         *
+         * @return pointer to the first byte of the input
+         */
+        const char* getBegin() const {
+            return this->_mapped != nullptr ? this->_mapped : this->_block.data();
+        };
 
-    }
+        /**
+         * @brief Get the End object.
+         *
+         * @return pointer past the last byte of the input
+         */
+        const char* getEnd() const { return this->getBegin() + this->_size; };
 
-    /* Outputs final result */
-    cout << graph->getNumberOfInterventions() << " " << sequence << endl;
+        /**
+         * @brief Get the Error object.
+         *
+         * @return description of the reading error, empty if there was none
+         */
+        const string& getError() const { return this->_error; };
 
-}
+};
 
 
 /**
- * @brief Driver code.
- *
- * @return terminate code
+ * @brief Parses an edge list ("nNodes nEdges" header followed by one "parent child" pair per line)
+ *        straight from memory, building the graph's CSR adjacency in two passes over the buffer.
  */
-int main() {
+class EdgeListParser {
 
-    /* Creates and populates the graph that is going to represent all the pieces' placement */
-    Graph graph = initGraph();
+    private:
+
+        /**
+         * @brief Holds the first byte of the input. Used to report byte offsets.
+         */
+        const char* _begin;
+
+        /**
+         * @brief Holds the next byte to be parsed.
+         */
+        const char* _cursor;
+
+        /**
+         * @brief Holds the byte past the end of the input.
+         */
+        const char* _end;
+
+        /**
+         * @brief Holds where the edges start, right after the header.
+         */
+        const char* _edges;
+
+        /**
+         * @brief Holds a description of the first malformed input found, empty if there was none.
+         */
+        string _error;
+
+        /**
+         * @brief Records a parsing error at the given position.
+         *
+         * @param at position of the offending byte
+         * @param message description of what was expected
+         * @return false, so it can be returned directly
+         */
+        bool fail(const char* at, const string& message) {
+            this->_error = "malformed input at byte " + to_string(at - this->_begin) + ": " + message;
+            return false;
+        };
+
+        /**
+         * @brief Skips every whitespace (including new lines) before the next token.
+         */
+        void skipWhitespace() {
+            while (this->_cursor != this->_end && (unsigned char) *this->_cursor <= ' ')
+                this->_cursor++;
+        };
+
+        /**
+         * @brief Skips spaces and tabs, stopping at new lines.
+         */
+        void skipBlanks() {
+            while (this->_cursor != this->_end && (*this->_cursor == ' ' || *this->_cursor == '\t'))
+                this->_cursor++;
+        };
+
+        /**
+         * @brief Reads a positive number, checking it is well formed.
+         *
+         * @param value where the number is stored
+         * @return true if a number was read
+         */
+        bool readNumber(int& value) {
+
+            const char* start = this->_cursor;
+            unsigned long long number = 0;
+            unsigned digit;
+
+            /* A single unsigned comparison tells digits apart from anything else */
+            while (this->_cursor != this->_end && (digit = *this->_cursor - '0') < 10) {
+                number = number * 10 + digit;
+                this->_cursor++;
+                if (number > INT_MAX) return this->fail(start, "number does not fit in an int");
+            }
+
+            if (this->_cursor == start) {
+                if (this->_cursor == this->_end) return this->fail(start, "unexpected end of input");
+                return this->fail(start, string("expected a number, found '") + *start + "'");
+            }
+
+            value = (int) number;
+            return true;
+
+        };
+
+        /**
+         * @brief Reads one "parent child" line, checking it is well formed and its nodes exist.
+         *
+         * @param nodes number of nodes inside graph
+         * @param parent where parent's node is stored
+         * @param child where child's node is stored
+         * @return true if the edge was read
+         */
+        bool readEdge(int nodes, int& parent, int& child) {
+
+            this->skipWhitespace();
+            const char* start = this->_cursor;
+            if (!this->readNumber(parent)) return false;
+
+            /* Both nodes must be on the same line */
+            this->skipBlanks();
+            if (this->_cursor != this->_end && (*this->_cursor == '\n' || *this->_cursor == '\r'))
+                return this->fail(this->_cursor, "expected child node before end of line");
+
+            const char* second = this->_cursor;
+            if (!this->readNumber(child)) return false;
+
+            /* Nothing else may follow on this line */
+            this->skipBlanks();
+            if (this->_cursor != this->_end && *this->_cursor == '\r') this->_cursor++;
+            if (this->_cursor != this->_end && *this->_cursor != '\n')
+                return this->fail(this->_cursor, "expected end of line after edge");
+
+            /* Both nodes must exist inside the graph */
+            if (parent < 1 || parent > nodes)
+                return this->fail(start, "parent node " + to_string(parent) + " is not in [1, " +
+                                  to_string(nodes) + "]");
+            if (child < 1 || child > nodes)
+                return this->fail(second, "child node " + to_string(child) + " is not in [1, " +
+                                  to_string(nodes) + "]");
+
+            return true;
+
+        };
+
+        /**
+         * @brief Reads the next number without any checks. Only used on input already validated.
+         *
+         * @return number read
+         */
+        int readTrustedNumber() {
+
+            this->skipWhitespace();
+
+            int number = 0;
+            unsigned digit;
+            while (this->_cursor != this->_end && (digit = *this->_cursor - '0') < 10) {
+                number = number * 10 + digit;
+                this->_cursor++;
+            }
+
+            return number;
+
+        };
+
+    public:
+
+        /**
+         * @brief EdgeListParser constructor.
+         *
+         * @param begin pointer to the first byte of the input
+         * @param end pointer past the last byte of the input
+         */
+        EdgeListParser(const char* begin, const char* end)
+            : _begin(begin), _cursor(begin), _end(end), _edges(begin) {};
+
+        /**
+         * @brief Reads the "nNodes nEdges" header.
+         *
+         * @param nodes where the number of nodes is stored
+         * @param edges where the number of edges is stored
+         * @return true if the header was read
+         */
+        bool readHeader(int& nodes, int& edges) {
+
+            this->skipWhitespace();
+            if (!this->readNumber(nodes)) return false;
+            this->skipWhitespace();
+            if (!this->readNumber(edges)) return false;
+
+            this->_edges = this->_cursor;
+            return true;
+
+        };
+
+        /**
+         * @brief Tells whether anything but whitespace is left, e.g. another instance of a stream
+         *        of concatenated edge lists.
+         *
+         * @return true if there is more input to parse
+         */
+        bool hasMoreInput() {
+            this->skipWhitespace();
+            return this->_cursor != this->_end;
+        };
+
+        /**
+         * @brief Validates every edge and counts their degrees inside the graph (first pass).
+         *
+         * @param graph graph whose degrees are counted
+         * @param edges number of edges to read
+         * @return true if every edge was well formed
+         */
+        bool countEdges(Graph* graph, int edges) {
+
+            int nodes = graph->getNumberOfNodes(), parent = 0, child = 0;
+
+            this->_cursor = this->_edges;
+            for (int i = 0; i < edges; i++) {
+                if (!this->readEdge(nodes, parent, child)) return false;
+                graph->countEdge(parent, child);
+            }
+
+            return true;
+
+        };
+
+        /**
+         * @brief Places every edge inside the graph's adjacency (second pass). Must only be called
+         *        after countEdges succeeded.
+         *
+         * @param graph graph being filled
+         * @param edges number of edges to read
+         */
+        void placeEdges(Graph* graph, int edges) {
+
+            this->_cursor = this->_edges;
+            for (int i = 0; i < edges; i++) {
+                int parent = this->readTrustedNumber();
+                int child = this->readTrustedNumber();
+                graph->placeEdge(parent, child);
+            }
+
+        };
+
+        /**
+         * @brief Get the Error object.
+         *
+         * @return description of the first malformed input, including its byte offset
+         */
+        const string& getError() const { return this->_error; };
+
+};
+
+
+/**
+ * @brief Fixed size header at the start of a binary graph (see convert-graph). Every section after
+ *        it starts at a multiple of 8 bytes, in this order:
+ *        - edge offsets: nodes + 1 uint64, node n's children are edges [offset[n-1], offset[n])
+ *        - byte offsets (compressed only): nodes + 1 uint64, where each node's varints start
+ *        - in degrees (optional): nodes uint32
+ *        - adjacency: edges int32 children, or adjacencyBytes of varint deltas when compressed
+ *        Every value is stored little endian.
+ *
+ * @param magic holds BINARY_GRAPH_MAGIC
+ * @param version holds BINARY_GRAPH_VERSION
+ * @param flags holds BINARY_HAS_IN_DEGREES and BINARY_COMPRESSED
+ * @param nodes number of nodes
+ * @param edges number of edges
+ * @param adjacencyBytes size of the adjacency section
+ * @param reserved always zero
+ */
+typedef struct binaryHeaderStruct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t nodes;
+    uint64_t edges;
+    uint64_t adjacencyBytes;
+    uint64_t reserved[3];
+} binaryHeaderStruct;
+
+
+/**
+ * @brief Rounds a size up to the next multiple of 8.
+ *
+ * @param size size to be rounded
+ * @return rounded size
+ */
+uint64_t align8(uint64_t size) { return (size + 7) & ~(uint64_t) 7; }
+
+
+/**
+ * @brief Decodes a LEB128 varint (7 bits per byte, high bit set on every byte but the last).
+ *
+ * @param cursor position of the varint's first byte. Moved past its last byte
+ * @param end position past the last byte that may be read
+ * @param value where the decoded value is stored
+ * @return true if the varint was complete and fits in 32 bits
+ */
+bool decodeVarint(const uint8_t*& cursor, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && cursor != end; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= (uint32_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Builds a graph from a binary graph held in memory. Uncompressed adjacencies are used in
+ *        place once checked, without being copied, so the memory is kept alive by the graph. Stored
+ *        in degrees must match the ones counted from the children.
+ *
+ * @param input memory holding the binary graph
+ * @param begin pointer to the first byte of the binary graph
+ * @param end pointer past the last byte of the binary graph
+ * @param error description of what is wrong with the input, when it is malformed
+ * @return newly created graph, or nullptr if the input is malformed
+ */
+unique_ptr<Graph> loadBinaryGraph(shared_ptr<const void> input, const char* begin, const char* end,
+                                  string& error) {
+
+    binaryHeaderStruct header;
+    uint64_t size = end - begin;
+    if (size < sizeof(header)) {
+        error = "binary graph: truncated header";
+        return nullptr;
+    }
+    memcpy(&header, begin, sizeof(header));
+
+    /* Every edge takes at least one byte, which keeps the layout below from overflowing */
+    if (header.version != BINARY_GRAPH_VERSION || header.nodes > INT_MAX || header.edges > size ||
+        header.adjacencyBytes > size) {
+        error = "binary graph: unsupported header";
+        return nullptr;
+    }
+
+    /* Finds where every section starts */
+    bool compressed = header.flags & BINARY_COMPRESSED;
+    uint64_t offsetsSize = (header.nodes + 1) * sizeof(uint64_t);
+    uint64_t byteOffsetsStart = sizeof(header) + offsetsSize;
+    uint64_t inDegreesStart = byteOffsetsStart + (compressed ? offsetsSize : 0);
+    uint64_t adjacencyStart = inDegreesStart;
+    if (header.flags & BINARY_HAS_IN_DEGREES)
+        adjacencyStart += align8(header.nodes * sizeof(uint32_t));
+    if (size < adjacencyStart + align8(header.adjacencyBytes)) {
+        error = "binary graph: truncated sections";
+        return nullptr;
+    }
+
+    int nodes = (int) header.nodes;
+    const uint64_t* edgeOffsets = reinterpret_cast<const uint64_t*>(begin + sizeof(header));
+    const uint64_t* byteOffsets = reinterpret_cast<const uint64_t*>(begin + byteOffsetsStart);
+
+    /* Offsets are cheap to check and a bad one would make every view point anywhere */
+    bool valid = edgeOffsets[0] == 0 && edgeOffsets[nodes] == header.edges &&
+                 (compressed ? byteOffsets[0] == 0 && byteOffsets[nodes] == header.adjacencyBytes
+                             : header.adjacencyBytes == header.edges * sizeof(int32_t));
+    for (int node = 1; valid && node <= nodes; node++)
+        valid = edgeOffsets[node] >= edgeOffsets[node-1] &&
+                (!compressed || byteOffsets[node] >= byteOffsets[node-1]);
+    if (!valid) {
+        error = "binary graph: offsets do not match the header";
+        return nullptr;
+    }
+
+    unique_ptr<Graph> graph(new Graph(nodes, header.edges));
+
+    if (!compressed) {
+
+        /* The children are used right where they are, so a bad one would be followed anywhere */
+        const int32_t* targets = reinterpret_cast<const int32_t*>(begin + adjacencyStart);
+        for (int node = 1; node <= nodes; node++) {
+            for (uint64_t edge = edgeOffsets[node-1]; edge < edgeOffsets[node]; edge++) {
+                if (targets[edge] < 1 || targets[edge] > nodes) {
+                    error = "binary graph: children of node " + to_string(node) + " are malformed";
+                    return nullptr;
+                }
+            }
+        }
+        graph->attachAdjacency(reinterpret_cast<const size_t*>(edgeOffsets),
+                               reinterpret_cast<const int*>(targets), input);
+
+    } else {
+
+        /* Decodes every node's sorted children from their varint encoded gaps */
+        for (int node = 1; node <= nodes; node++)
+            graph->addNodeDegrees(node, edgeOffsets[node] - edgeOffsets[node-1], 0);
+        graph->allocateAdjacency();
+
+        const uint8_t* adjacency = reinterpret_cast<const uint8_t*>(begin + adjacencyStart);
+        for (int node = 1; node <= nodes; node++) {
+            const uint8_t* cursor = adjacency + byteOffsets[node-1];
+            const uint8_t* stop = adjacency + byteOffsets[node];
+            uint32_t child = 0, delta = 0;
+            for (uint64_t edge = edgeOffsets[node-1]; edge < edgeOffsets[node]; edge++) {
+                if (!decodeVarint(cursor, stop, delta) || (child += delta) > (uint32_t) nodes ||
+                    child == 0) {
+                    error = "binary graph: children of node " + to_string(node) + " are malformed";
+                    return nullptr;
+                }
+                graph->placeEdge(node, (int) child);
+            }
+        }
+        graph->finishAdjacency();
+
+    }
+
+    /* In degrees are counted from the children, which were just checked. Stored ones must match
+     * them node by node */
+    for (int node = 1; node <= nodes; node++)
+        for (int child : graph->getAdjacentNodes(node))
+            graph->addNodeDegrees(child, 0, 1);
+    if (header.flags & BINARY_HAS_IN_DEGREES) {
+        const uint32_t* inDegrees = reinterpret_cast<const uint32_t*>(begin + inDegreesStart);
+        for (int node = 1; node <= nodes; node++) {
+            if (inDegrees[node-1] != (uint32_t) graph->getNodeInDegree(node)) {
+                error = "binary graph: in degree of node " + to_string(node) + " is " +
+                        to_string(inDegrees[node-1]) + ", expected " +
+                        to_string(graph->getNodeInDegree(node));
+                return nullptr;
+            }
+        }
+    }
+
+    return graph;
+
+}
+
+
+/**
+ * @brief Reads the next "nNodes nEdges" header and its edges into a graph, reusing its buffers.
+ *        Leaves the parser right after the last edge, where the next instance (if any) starts.
+ *
+ * @param parser parser positioned before the header
+ * @param graph graph being reset and filled
+ * @return true if the instance was well formed. Otherwise the parser holds the error
+ */
+bool loadInstance(EdgeListParser* parser, Graph* graph) {
+
+    /* Reads number of nodes and edges */
+    int nNodes = 0, nEdges = 0;
+    if (!parser->readHeader(nNodes, nEdges)) return false;
+
+    /* Resets graph and counts every node's degrees while validating the edges */
+    graph->reset(nNodes, nEdges);
+    if (!parser->countEdges(graph, nEdges)) return false;
+
+    /* Lays every node's children contiguously by parsing the edges a second time */
+    graph->allocateAdjacency();
+    parser->placeEdges(graph, nEdges);
+    graph->finishAdjacency();
+
+    return true;
+
+}
+
+
+/**
+ * @brief Creates and populates the graph that is going to represent all the pieces' placement.
+ *        Stdin is mapped (or block read) and its edges are parsed straight from memory. Binary
+ *        graphs are used without any parsing.
+ *
+ * @return newly created graph
+ */
+Graph initGraph() {
+
+    shared_ptr<InputBuffer> input = make_shared<InputBuffer>(STDIN_FILENO);
+    if (!input->getError().empty()) {
+        cerr << input->getError() << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /* Binary graphs are recognized by their first bytes. The graph keeps the input alive */
+    const char* begin = input->getBegin();
+    const char* end = input->getEnd();
+    if (end - begin >= 8 && memcmp(begin, BINARY_GRAPH_MAGIC, 8) == 0) {
+        string error;
+        unique_ptr<Graph> graph = loadBinaryGraph(input, begin, end, error);
+        if (!graph) {
+            cerr << error << endl;
+            exit(EXIT_FAILURE);
+        }
+        return move(*graph);
+    }
+
+    EdgeListParser parser(begin, end);
+    Graph graph(0, 0);
+    if (!loadInstance(&parser, &graph)) {
+        cerr << parser.getError() << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return graph;
+
+}
+
+
+/**
+ * @brief Measures the wall time of the program's phases, one after the other.
+ */
+class PhaseTimer {
+
+    private:
+
+        /**
+         * @brief Holds every finished phase's name and seconds.
+         */
+        vector<pair<string, double>> _phases;
+
+        /**
+         * @brief Holds the running phase's name, empty if none is running.
+         */
+        string _current;
+
+        /**
+         * @brief Holds when the running phase started.
+         */
+        chrono::steady_clock::time_point _start;
+
+    public:
+
+        /**
+         * @brief Ends the running phase, if any, and starts a new one.
+         *
+         * @param name phase name
+         */
+        void start(const string& name) {
+            this->stop();
+            this->_current = name;
+            this->_start = chrono::steady_clock::now();
+        };
+
+        /**
+         * @brief Ends the running phase, if any.
+         */
+        void stop() {
+            if (this->_current.empty()) return;
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - this->_start;
+            this->_phases.emplace_back(this->_current, elapsed.count());
+            this->_current.clear();
+        };
+
+        /**
+         * @brief Get the Phases object.
+         *
+         * @return every finished phase's name and seconds, in the order they ran
+         */
+        const vector<pair<string, double>>& getPhases() const { return this->_phases; };
+
+};
+
+
+/**
+ * @brief Raises the distance of every child of a node to at least a given one. All the children
+ *        get the same candidate distance, so lanes holding the same child always write the same
+ *        value. A repeated child still grows only once, so every kernel returns the same count.
+ *
+ * @param distances every node's distance, node n at position n - 1
+ * @param children the node's children
+ * @param count number of children
+ * @param dist candidate distance (the node's one plus 1)
+ * @return number of distances that grew
+ */
+typedef size_t (*relaxKernel)(int* distances, const int* children, size_t count, int dist);
+
+
+/**
+ * @brief Scalar relaxation, one child at a time. Used on CPUs without AVX2 and for the children
+ *        left over by the vector kernels.
+ *
+ * @param distances every node's distance, node n at position n - 1
+ * @param children the node's children
+ * @param count number of children
+ * @param dist candidate distance (the node's one plus 1)
+ * @return number of distances that grew
+ */
+size_t relaxScalar(int* distances, const int* children, size_t count, int dist) {
+    size_t updated = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (distances[children[i]-1] < dist) {
+            distances[children[i]-1] = dist;
+            updated++;
+        }
+    }
+    return updated;
+}
+
+
+#ifndef DOMINO_NO_SIMD
+
+/**
+ * @brief AVX2 relaxation, 8 children at a time. Their distances are gathered and compared with the
+ *        candidate one. AVX2 has no scatter, so only the lanes that grow are stored, one by one,
+ *        each checked again so that a child repeated among them is only counted once.
+ *
+ * @param distances every node's distance, node n at position n - 1
+ * @param children the node's children
+ * @param count number of children
+ * @param dist candidate distance (the node's one plus 1)
+ * @return number of distances that grew
+ */
+__attribute__((target("avx2")))
+size_t relaxAvx2(int* distances, const int* children, size_t count, int dist) {
+
+    const __m256i candidate = _mm256_set1_epi32(dist), one = _mm256_set1_epi32(1);
+    size_t updated = 0, i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i index = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*) (children + i)), one);
+        __m256i current = _mm256_i32gather_epi32(distances, index, 4);
+        __m256i greater = _mm256_cmpgt_epi32(candidate, current);
+        unsigned grow = _mm256_movemask_ps(_mm256_castsi256_ps(greater));
+        for (; grow != 0; grow &= grow - 1) {
+            int child = children[i + __builtin_ctz(grow)];
+            if (distances[child-1] >= dist) continue;
+            distances[child-1] = dist;
+            updated++;
+        }
+    }
+
+    return updated + relaxScalar(distances, children + i, count - i, dist);
+
+}
+
+
+/**
+ * @brief AVX-512 relaxation, 16 children at a time. Their distances are gathered, compared with the
+ *        candidate one and scattered back only where they grow. Lanes repeating an earlier growing
+ *        lane's child are found with AVX-512 CD and left out, so each child is counted once. The
+ *        last children are handled by the same loop with a partial mask.
+ *
+ * @param distances every node's distance, node n at position n - 1
+ * @param children the node's children
+ * @param count number of children
+ * @param dist candidate distance (the node's one plus 1)
+ * @return number of distances that grew
+ */
+__attribute__((target("avx512f,avx512cd")))
+size_t relaxAvx512(int* distances, const int* children, size_t count, int dist) {
+
+    const __m512i candidate = _mm512_set1_epi32(dist), one = _mm512_set1_epi32(1);
+    size_t updated = 0;
+
+    for (size_t i = 0; i < count; i += 16) {
+        __mmask16 lanes = count - i >= 16 ? (__mmask16) 0xFFFF
+                                          : (__mmask16) ((1u << (count - i)) - 1);
+        __m512i index = _mm512_maskz_sub_epi32(lanes, _mm512_maskz_loadu_epi32(lanes, children + i),
+                                               one);
+        __m512i current = _mm512_mask_i32gather_epi32(candidate, lanes, index, distances, 4);
+        __mmask16 grow = _mm512_mask_cmpgt_epi32_mask(lanes, candidate, current);
+        __m512i earlier = _mm512_maskz_conflict_epi32(grow, index);
+        grow &= ~_mm512_mask_test_epi32_mask(grow, earlier, _mm512_set1_epi32(grow));
+        _mm512_mask_i32scatter_epi32(distances, grow, index, candidate, 4);
+        updated += __builtin_popcount(grow);
+    }
+
+    return updated;
+
+}
+
+#endif
+
+
+/**
+ * @brief Gets the relaxation kernel for this CPU, chosen once through CPUID: AVX-512 gathers and
+ *        masked scatters, AVX2 gathers with scalar stores for the lanes that grow, or plain scalar
+ *        code. Building with -DDOMINO_NO_SIMD always gives the scalar one.
+ *
+ * @return relaxation kernel
+ */
+relaxKernel getRelaxKernel() {
+#ifndef DOMINO_NO_SIMD
+    static const relaxKernel kernel = __builtin_cpu_supports("avx512f") &&
+                                      __builtin_cpu_supports("avx512cd") ? relaxAvx512
+                                    : __builtin_cpu_supports("avx2") ? relaxAvx2 : relaxScalar;
+    return kernel;
+#else
+    return relaxScalar;
+#endif
+}
+
+
+/**
+ * @brief Get the Relax Kernel Name object.
+ *
+ * @return name of the kernel getRelaxKernel gives (avx512, avx2 or scalar)
+ */
+const char* getRelaxKernelName() {
+#ifndef DOMINO_NO_SIMD
+    relaxKernel kernel = getRelaxKernel();
+    if (kernel == relaxAvx512) return "avx512";
+    if (kernel == relaxAvx2) return "avx2";
+#endif
+    return "scalar";
+}
+
+
+/**
+ * @brief Prints every phase's wall time, the peak DFS auxiliary size and, when built with
+ *        -DDOMINO_STATS, every counter of solverStats.
+ *
+ * @param out stream the report is written to
+ * @param timer phases measured
+ * @param peakDfsAuxSize most frames the DFS held at once (0 if it did not run)
+ */
+void printStats(ostream& out, const PhaseTimer& timer, size_t peakDfsAuxSize) {
+
+    for (const auto& phase : timer.getPhases())
+        out << "phase " << phase.first << ": " << phase.second << " s" << endl;
+    out << "peak dfs aux size: " << peakDfsAuxSize << endl;
+    out << "relax kernel: " << getRelaxKernelName() << endl;
+
+#ifdef DOMINO_STATS
+    out << "edges relaxed: " << solverStats.edgesRelaxed << endl;
+    out << "distance updates: " << solverStats.distanceUpdates << endl;
+    out << "dfs pushes: " << solverStats.dfsPushes << endl;
+    out << "dfs visits: " << solverStats.dfsVisits << endl;
+    out << "allocations: " << solverStats.allocations << " (" << solverStats.allocatedBytes
+        << " bytes)" << endl;
+#else
+    out << "counters: not built in, build with -DDOMINO_STATS (make stats)" << endl;
+#endif
+
+}
+
+
+/**
+ * @brief Solves the domino problem on graphs that may have cycles. Pieces toppling each other in a
+ *        loop all fall together, so the graph is condensed into a DAG of its strongly connected
+ *        components, each weighted by its size. The interventions are the components no other one
+ *        reaches and the longest sequence is the heaviest path of components. Prints them.
+ *
+ * @param graph graph representing domino problem which will be traversed
+ */
+void solveWithComponents(Graph* graph) {
+
+    componentsStruct components = graph->components();
+    int count = components.start.size() - 1, interventions = 0, sequence = 1;
+
+    /* Every node's distance holds the heaviest sequence reaching it from other components, until
+     * its own component is solved and it takes that component's one */
+    for (int node = 1; node <= graph->getNumberOfNodes(); node++) graph->setNodeDistance(node, 0);
+
+    /* Components are relaxed in topological order, that is the reverse of how they were closed */
+    for (int id = count - 1; id >= 0; id--) {
+
+        int first = components.start[id], last = components.start[id+1], size = last - first;
+
+        /* Nothing reaching any of its nodes from outside means it has to be pushed */
+        int dist = 0;
+        for (int i = first; i < last; i++)
+            dist = max(dist, graph->getNodeDistance(components.members[i]));
+        if (dist == 0) interventions++;
+        dist += size;
+        sequence = max(sequence, dist);
+
+        for (int i = first; i < last; i++) {
+
+            int node = components.members[i];
+            graph->setNodeDistance(node, dist);
+
+            adjacencyViewStruct children = graph->getAdjacentNodes(node);
+            STATS_ADD(edgesRelaxed, children.size());
+
+            /* Edges inside the component are skipped. A single node only has itself in there */
+            for (int child : children) {
+                if (size == 1 ? child == node : components.component[child-1] == id) continue;
+                if (graph->getNodeDistance(child) < dist) {
+                    graph->setNodeDistance(child, dist);
+                    STATS_ADD(distanceUpdates, 1);
+                }
+            }
+
+        }
+
+    }
+
+    /* Outputs final result */
+    cout << interventions << " " << sequence << "\n";
+
+}
+
+
+/**
+ * @brief Counts number os times we have to make a piece fall to traverse all the pieces (is just
+ *        the amount of node with in degree 0). Also finds longest path in our graph. If the DFS
+ *        found a cycle, the order is not valid and the graph is condensed into its components.
+ *        Unless predecessors are wanted, children are relaxed by the vector kernel this CPU
+ *        supports.
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @param topological stack with nodes in topological order
+ * @param predecessors if not null, receives every node's parent in its longest sequence (0 for
+ *        nodes starting one). Must hold one entry per node
+ */
+void solveDominoPiecesProblem(Graph* graph, deque<int>* topological,
+                              vector<int>* predecessors = nullptr) {
+
+    if (graph->hasCycle()) {
+        solveWithComponents(graph);
+        return;
+    }
+
+    /* Holds the number of nodes traversed in the longest sequence of dominoes */
+    int sequence = 1;
+
+    /* The kernel works straight on the distances array */
+    int* distances = graph->getNodeDistances();
+    relaxKernel relax = getRelaxKernel();
+
+    /* We traverse all the nodes in our topological stack and traverse them one by one. While doing
+     * this, we traverse their children and change their distance. This will count the number of
+     * edges between them and their parents */
+    while ( ! topological->empty()) {
+
+        /* Gets node from stack */
+        int node = topological->front(); topological->pop_front();
+
+        /* Traverses children sets their distance */
+        if (graph->getNodeDistance(node) != NEGATIVE_INFINITY) {
+
+            int dist = graph->getNodeDistance(node) + 1;
+
+            /* Children are walked through a view, so nothing is copied or allocated here */
+            adjacencyViewStruct children = graph->getAdjacentNodes(node);
+            STATS_ADD(edgesRelaxed, children.size());
+
+            /* A child not growing already had a distance at least as long, which some earlier
+             * relaxation set, so the sequence can be raised without looking at each child */
+            if (predecessors == nullptr) {
+                size_t updated = relax(distances, children.begin(), children.size(), dist);
+                STATS_ADD(distanceUpdates, updated);
+                if (!children.empty()) sequence = max(sequence, dist);
+                continue;
+            }
+
+            for (int child : children) {
+
+                if (graph->getNodeDistance(child) < dist) {
+
+                    graph->setNodeDistance(child, dist);
+                    if (predecessors) (*predecessors)[child-1] = node;
+                    STATS_ADD(distanceUpdates, 1);
+
+                    /* Finds and holds longest distance. Is done here as to avoid doing another loop
+                     * to find the highest distance */
+                    if (dist > sequence) sequence = dist;
+
+                }
+
+            }
+
+        }
+
+    }
+
+    /* Outputs final result */
+    cout << graph->getNumberOfInterventions() << " " << sequence << "\n";
+
+}
+
+
+/**
+ * @brief Solves every instance of a stream of concatenated edge lists on stdin, one after the other,
+ *        printing one answer line per instance. A single graph is reset for every instance, so its
+ *        buffers are only allocated again when an instance outgrows them.
+ */
+void solveBatch() {
+
+    InputBuffer input(STDIN_FILENO);
+    if (!input.getError().empty()) {
+        cerr << input.getError() << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    EdgeListParser parser(input.getBegin(), input.getEnd());
+    Graph graph(0, 0);
+
+    for (int instance = 1; parser.hasMoreInput(); instance++) {
+
+        if (!loadInstance(&parser, &graph)) {
+            cout.flush();
+            cerr << "instance " << instance << ": " << parser.getError() << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        deque<int> topological = graph.dfs();
+        solveDominoPiecesProblem(&graph, &topological);
+
+    }
+
+}
+
+
+/**
+ * @brief Prints the longest sequences ending at the pieces that topple nothing else, largest
+ *        distances first, one per line, from the piece pushed to the last one falling. None is a
+ *        prefix of another. Cyclic graphs were solved on their components, which keep no
+ *        predecessors.
+ *
+ * @param graph solved graph
+ * @param predecessors every node's parent in its longest sequence
+ * @param count number of sequences to print
+ */
+void printChains(const Graph* graph, const vector<int>& predecessors, int count) {
+
+    if (graph->hasCycle()) {
+        cerr << "no chains: the pieces are placed with cycles" << endl;
+        return;
+    }
+
+    /* Only sequences ending at a piece toppling nothing are kept, so none is part of another.
+     * The ends of the longest ones are sorted, ties going to the smallest node */
+    vector<int> ends;
+    for (int node = 1; node <= graph->getNumberOfNodes(); node++)
+        if (graph->getAdjacentNodes(node).empty()) ends.push_back(node);
+    count = min(count, (int) ends.size());
+    partial_sort(ends.begin(), ends.begin() + count, ends.end(), [graph](int first, int second) {
+        int firstDist = graph->getNodeDistance(first), secondDist = graph->getNodeDistance(second);
+        return firstDist != secondDist ? firstDist > secondDist : first < second;
+    });
+
+    /* Every sequence is walked backwards from its end and printed the other way around */
+    vector<int> chain;
+    for (int i = 0; i < count; i++) {
+        chain.clear();
+        for (int node = ends[i]; node != 0; node = predecessors[node-1]) chain.push_back(node);
+        for (size_t j = chain.size(); j-- > 0; ) cout << chain[j] << (j ? " " : "\n");
+    }
+
+}
+
+
+/**
+ * @brief Driver code. With --stats, prints each phase's wall time and the hot path counters on
+ *        stderr. With --batch, solves every instance of concatenated edge lists. With --chains K,
+ *        also prints the K longest sequences of pieces.
+ *
+ * @return terminate code
+ */
+int main(int argc, char *argv[]) {
+
+    bool reportStats = false, batch = false;
+    int chains = 0;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--stats") reportStats = true;
+        else if (string(argv[i]) == "--batch") batch = true;
+        else if (string(argv[i]) == "--chains" && i + 1 < argc) chains = max(0, atoi(argv[++i]));
+    }
+    PhaseTimer timer;
+
+    if (batch) {
+        timer.start("batch");
+        solveBatch();
+        timer.stop();
+        if (reportStats) printStats(cerr, timer, 0);
+        exit(EXIT_SUCCESS);
+    }
+
+    /* Creates and populates the graph that is going to represent all the pieces' placement */
+    timer.start("load");
+    Graph graph = initGraph();
 
     /* Performs a DFS and returns an array with all the vertices inversely sorted by finish time */
+    timer.start("order");
     deque<int> topological = graph.dfs();
 
+    /* Predecessors are only kept when the chains themselves are wanted */
+    vector<int> predecessors;
+    if (chains > 0) predecessors.assign(graph.getNumberOfNodes(), 0);
+
     /* Finds minimum interventions and biggest sequence. Prints them on the screen */
-    solveDominoPiecesProblem(&graph, &topological);
+    timer.start("path");
+    solveDominoPiecesProblem(&graph, &topological, chains > 0 ? &predecessors : nullptr);
+    timer.stop();
+    if (chains > 0) printChains(&graph, predecessors, chains);
+
+    if (reportStats) printStats(cerr, timer, graph.getPeakDfsAuxSize());
 
     exit(EXIT_SUCCESS);
 
@@ -1,4 +1,5 @@
 #include "graph.h"
+#include "stats.h"
 
 
 using namespace std;
@@ -8,15 +9,56 @@ using namespace std;
  * @brief Graph constructor.
  *
  * @param nodes number of nodes inside graph
+ * @param edges upper bound on the number of edges, used to size the in degrees
+ * @param arena where every buffer is allocated, nullptr to use the heap
  */
-Graph::Graph(int nodes) {
+template <class NodeState>
+BasicGraph<NodeState>::BasicGraph(int nodes, size_t edges, shared_ptr<Arena> arena)
+    : _nodeInfo(0, 0), _arena(arena) {
+    this->reset(nodes, edges);
+}
+
 
-    /* Populates info vector with all the possible nodes */
-    nodeInfoStruct info;
-    this->_nodeInfo.resize(nodes, info);
+/**
+ * @brief Empties this graph and gives it a new number of nodes, as if it had just been constructed,
+ *        but keeping every buffer's memory so that many graphs of similar size can be built one
+ *        after the other without allocating again. With an arena, the arena is rewound instead, so
+ *        nothing drawn from it before may be used anymore.
+ *
+ * @param nodes number of nodes inside graph
+ * @param edges upper bound on the number of edges, used to size the in degrees
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::reset(int nodes, size_t edges) {
+
+    /* Every buffer lets go of its old memory (freeing into an arena costs nothing) and starts
+     * drawing from the beginning of the arena again */
+    if (this->_arena) {
+        this->_arena->reset();
+        ArenaAllocator<int> allocator = this->getAllocator();
+        this->_nodeInfo = NodeState(0, 0, allocator);
+        this->_offsets = arenaVector<size_t>(allocator);
+        this->_targets = arenaVector<int>(allocator);
+        this->_pendingEdges = arenaVector<pair<int, int>>(allocator);
+        this->_cursor = arenaVector<size_t>(allocator);
+        this->_parentOffsets = arenaVector<size_t>(allocator);
+        this->_parents = arenaVector<int>(allocator);
+    }
 
-    /* Creates and allocates space for all the nodes' connections */
-    this->_adjacent.resize(nodes);
+    this->_nodeInfo.reset(nodes, edges);
+
+    /* Creates space for every node's out degree (later turned into offsets). Node n uses
+     * position n so that position 0 stays as the start of the first node */
+    this->_offsets.assign(nodes + 1, 0);
+    this->_targets.clear();
+    this->_adjacency = this->_targets.data();
+    this->_external.reset();
+    this->_pendingEdges.clear();
+    this->_cursor.clear();
+    this->_parentOffsets.clear();
+    this->_parents.clear();
+    this->_peakDfsAuxSize = 0;
+    this->_hasCycle = false;
 
     /* Saves number of nodes */
     this->_numberOfNodes = nodes;
@@ -28,18 +70,94 @@ Graph::Graph(int nodes) {
  * @brief Get the Node Info object.
  * 
  * @param node node value
- * @return nodeInfoStruct related to this node
+ * @return copy of every field related to this node
  */
-nodeInfoStruct Graph::getNodeInfo(int node) { return this->_nodeInfo[node-1]; }
+template <class NodeState>
+nodeInfoStruct BasicGraph<NodeState>::getNodeInfo(int node) const {
+    return this->_nodeInfo.getInfo(node - 1);
+}
+
+
+/**
+ * @brief Get the Node Color object.
+ *
+ * @param node node value
+ * @return node's current color
+ */
+template <class NodeState>
+Color BasicGraph<NodeState>::getNodeColor(int node) const {
+    return this->_nodeInfo.getColor(node - 1);
+}
+
+
+/**
+ * @brief Get the Node In Degree object.
+ *
+ * @param node node value
+ * @return number of edges leading to this node
+ */
+template <class NodeState>
+int BasicGraph<NodeState>::getNodeInDegree(int node) const {
+    return this->_nodeInfo.getInDegree(node - 1);
+}
+
+
+/**
+ * @brief Get the Node Distance object.
+ *
+ * @param node node value
+ * @return node's current distance
+ */
+template <class NodeState>
+int BasicGraph<NodeState>::getNodeDistance(int node) const {
+    return this->_nodeInfo.getDistance(node - 1);
+}
+
+
+/**
+ * @brief Get the Node Distances object. Lets vectorized loops read and write distances directly.
+ *
+ * @return every node's distance, node n at position n - 1, or nullptr if the node state layout
+ *         does not keep them contiguous
+ */
+template <class NodeState>
+int* BasicGraph<NodeState>::getNodeDistances() { return this->_nodeInfo.getDistances(); }
 
 
 /**
  * @brief Get the Adjacent Nodes object.
  * 
  * @param node node value
- * @return list<int> representing a list of connected nodes
+ * @return view over this node's children inside the contiguous adjacency
+ */
+template <class NodeState>
+adjacencyViewStruct BasicGraph<NodeState>::getAdjacentNodes(int node) const {
+    const int* targets = this->_adjacency;
+    return adjacencyViewStruct(targets + this->_offsets[node-1], targets + this->_offsets[node]);
+}
+
+
+/**
+ * @brief Get the Parent Nodes object. Only valid after buildParentAdjacency.
+ *
+ * @param node node value
+ * @return view over the nodes leading to this node
+ */
+template <class NodeState>
+adjacencyViewStruct BasicGraph<NodeState>::getParentNodes(int node) const {
+    const int* parents = this->_parents.data();
+    return adjacencyViewStruct(parents + this->_parentOffsets[node-1],
+                               parents + this->_parentOffsets[node]);
+}
+
+
+/**
+ * @brief Tells whether the parent adjacency was built.
+ *
+ * @return true if getParentNodes can be used
  */
-list<int> Graph::getAdjacentNodes(int node) { return this->_adjacent[node-1]; }
+template <class NodeState>
+bool BasicGraph<NodeState>::hasParentAdjacency() const { return !this->_parentOffsets.empty(); }
 
 
 /**
@@ -47,7 +165,67 @@ list<int> Graph::getAdjacentNodes(int node) { return this->_adjacent[node-1]; }
  *
  * @return number of nodes
  */
-int Graph::getNumberOfNodes() const { return this->_numberOfNodes; }
+template <class NodeState>
+int BasicGraph<NodeState>::getNumberOfNodes() const { return this->_numberOfNodes; }
+
+
+/**
+ * @brief Get the Peak Dfs Aux Size object.
+ *
+ * @return most frames the last dfs() ever held at once
+ */
+template <class NodeState>
+size_t BasicGraph<NodeState>::getPeakDfsAuxSize() const { return this->_peakDfsAuxSize; }
+
+
+/**
+ * @brief Tells whether a traversal found a cycle. Only valid once dfs() or any other topological
+ *        sort ran.
+ *
+ * @return true if some piece, directly or not, makes itself fall
+ */
+template <class NodeState>
+bool BasicGraph<NodeState>::hasCycle() const { return this->_hasCycle; }
+
+
+/**
+ * @brief Get the Allocator object.
+ *
+ * @return allocator drawing from this graph's arena (the heap if it has none). Used for scratch
+ *         space that should live as long as the graph's current contents
+ */
+template <class NodeState>
+ArenaAllocator<int> BasicGraph<NodeState>::getAllocator() const {
+    return ArenaAllocator<int>(this->_arena.get());
+}
+
+
+/**
+ * @brief Get the Arena Bytes object.
+ *
+ * @param nodes number of nodes
+ * @param edges number of edges
+ * @return bytes a graph of this size draws from its arena, including one traversal
+ */
+template <class NodeState>
+size_t BasicGraph<NodeState>::getArenaBytes(int nodes, size_t edges) {
+
+    /* Offsets and fill cursors, children, every node's state and, for the traversal, a frame and a
+     * place in the topological order per node */
+    size_t perNode = 2 * sizeof(size_t) + sizeof(nodeInfoStruct) + sizeof(dfsFrameStruct) +
+                     sizeof(int);
+    return (size_t) (nodes + 1) * perNode + edges * sizeof(int);
+
+}
+
+
+/**
+ * @brief Get the Number of Edges object. Only valid once the adjacency is built.
+ *
+ * @return number of edges
+ */
+template <class NodeState>
+size_t BasicGraph<NodeState>::getNumberOfEdges() const { return this->_offsets.back(); }
 
 
 /**
@@ -56,7 +234,18 @@ int Graph::getNumberOfNodes() const { return this->_numberOfNodes; }
  * @param node node to be changed
  * @param color new color
  */
-void Graph::setNodeColor(int node, Color color) { this->_nodeInfo[node-1].color = color; }
+template <class NodeState>
+void BasicGraph<NodeState>::setNodeColor(int node, Color color) {
+    this->_nodeInfo.setColor(node - 1, color);
+}
+
+
+/**
+ * @brief Records that a traversal found a cycle, so that solvers needing a topological order hand
+ *        the graph over to the components solver.
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::markCycle() { this->_hasCycle = true; }
 
 
 /**
@@ -64,7 +253,22 @@ void Graph::setNodeColor(int node, Color color) { this->_nodeInfo[node-1].color
  *
  * @param node node to be changed
  */
-void Graph::incrementNodeInDegree(int node) { this->_nodeInfo[node-1].inDegree++; }
+template <class NodeState>
+void BasicGraph<NodeState>::incrementNodeInDegree(int node) {
+    this->_nodeInfo.setInDegree(node - 1, this->_nodeInfo.getInDegree(node - 1) + 1);
+}
+
+
+/**
+ * @brief Changes node's total in degree value.
+ *
+ * @param node node to be changed
+ * @param inDegree new in degree
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::setNodeInDegree(int node, int inDegree) {
+    this->_nodeInfo.setInDegree(node - 1, inDegree);
+}
 
 
 /**
@@ -73,19 +277,81 @@ void Graph::incrementNodeInDegree(int node) { this->_nodeInfo[node-1].inDegree++
  * @param node node to be changed
  * @param dist new distance
  */
-void Graph::setNodeDistance(int node, int dist) { this->_nodeInfo[node-1].dist = dist; }
+template <class NodeState>
+void BasicGraph<NodeState>::setNodeDistance(int node, int dist) {
+    this->_nodeInfo.setDistance(node - 1, dist);
+}
+
+
+/**
+ * @brief Raises the upper bound on the number of edges given at construction, so that in degrees
+ *        keep fitting when edges are added to an already built graph.
+ *
+ * @param edges new upper bound on the number of edges
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::growEdgeBound(size_t edges) { this->_nodeInfo.growEdgeBound(edges); }
+
+
+/**
+ * @brief Reserves space for the edge stream. Avoids regrowing it when the number of edges is known
+ *        beforehand.
+ *
+ * @param edges number of edges that are going to be added
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::reserveEdges(size_t edges) { this->_pendingEdges.reserve(edges); }
 
 
 /**
- * @brief Inserts a new edge from parent to child node.
+ * @brief Inserts a new edge from parent to child node. The edge only becomes visible through the
+ *        adjacency accessors after buildAdjacency is called.
  *
  * @param parent parent's node
  * @param child child's node
  */
-void Graph::addEdge(int parent, int child) {
+template <class NodeState>
+void BasicGraph<NodeState>::addEdge(int parent, int child) {
 
-    /* Creates a connection between two nodes */
-    this->_adjacent[parent-1].push_back(child);
+    /* Keeps the connection until the adjacency is built, counting its degrees right away */
+    this->_pendingEdges.emplace_back(parent, child);
+    this->countEdge(parent, child);
+
+}
+
+
+/**
+ * @brief Builds the CSR adjacency from every edge added so far. Out degrees were already counted by
+ *        addEdge, so this turns them into offsets and fills each node's children.
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::buildAdjacency() {
+
+    this->allocateAdjacency();
+
+    /* Places every child right after its parent's previous ones, keeping insertion order */
+    for (const auto& edge : this->_pendingEdges)
+        this->placeEdge(edge.first, edge.second);
+
+    /* The edge stream is no longer needed, so its memory is given back */
+    arenaVector<pair<int, int>>(this->getAllocator()).swap(this->_pendingEdges);
+    this->finishAdjacency();
+
+}
+
+
+/**
+ * @brief First pass of a two pass construction. Counts an edge's out and in degrees without keeping
+ *        the edge itself, for callers that can replay their edge stream.
+ *
+ * @param parent parent's node
+ * @param child child's node
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::countEdge(int parent, int child) {
+
+    /* Counts parent's out degree. It is turned into an offset by allocateAdjacency */
+    this->_offsets[parent]++;
 
     /* Increments child's in degrees */
     this->incrementNodeInDegree(child);
@@ -94,54 +360,303 @@ void Graph::addEdge(int parent, int child) {
 
 
 /**
- * @brief Performs an iterative DFS traversal of this graph starting from first node (1).
+ * @brief Turns the counted out degrees into offsets and allocates the contiguous adjacency. Must be
+ *        called between the countEdge and placeEdge passes.
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::allocateAdjacency() {
+
+    /* Turns out degrees into offsets. After this, node n's children end at _offsets[n] */
+    for (int node = 1; node <= this->getNumberOfNodes(); node++)
+        this->_offsets[node] += this->_offsets[node-1];
+
+    /* Every node starts filling its children at its own offset */
+    this->_cursor.assign(this->_offsets.begin(), this->_offsets.end() - 1);
+    this->_targets.resize(this->_offsets.back());
+    this->_adjacency = this->_targets.data();
+
+}
+
+
+/**
+ * @brief Second pass of a two pass construction. Places a previously counted edge right after its
+ *        parent's other children.
+ *
+ * @param parent parent's node
+ * @param child child's node
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::placeEdge(int parent, int child) {
+    this->_targets[this->_cursor[parent-1]++] = child;
+}
+
+
+/**
+ * @brief Ends a two pass construction by releasing the memory used while filling.
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::finishAdjacency() {
+    arenaVector<size_t>(this->getAllocator()).swap(this->_cursor);
+}
+
+
+/**
+ * @brief Counts many edges of a node at once, as countEdge would have done one by one. Used to merge
+ *        degrees counted elsewhere (e.g. by parallel loaders).
+ *
+ * @param node node to be changed
+ * @param outDegree number of edges leaving this node
+ * @param inDegree number of edges reaching this node
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::addNodeDegrees(int node, size_t outDegree, int inDegree) {
+    this->_offsets[node] += outDegree;
+    this->_nodeInfo.setInDegree(node - 1, this->_nodeInfo.getInDegree(node - 1) + inDegree);
+}
+
+
+/**
+ * @brief Get the Adjacency Start object. Only valid after allocateAdjacency.
+ *
+ * @param node node value
+ * @return position inside the contiguous adjacency where this node's children start
+ */
+template <class NodeState>
+size_t BasicGraph<NodeState>::getAdjacencyStart(int node) const {
+    return this->_offsets[node-1];
+}
+
+
+/**
+ * @brief Places a child at an exact position of the contiguous adjacency. Different threads may call
+ *        it at the same time as long as they write different positions.
+ *
+ * @param position position inside the contiguous adjacency
+ * @param child child's node
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::placeEdgeAt(size_t position, int child) {
+    this->_targets[position] = child;
+}
+
+
+/**
+ * @brief Uses an adjacency stored elsewhere instead of building one. The children are not copied,
+ *        so loading a graph costs only the pages actually touched.
+ *
+ * @param offsets nodes + 1 offsets, with the same meaning as after buildAdjacency
+ * @param targets every node's children, stored contiguously per parent
+ * @param owner keeps targets' memory alive while this graph uses it
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::attachAdjacency(const size_t* offsets, const int* targets,
+                                            shared_ptr<const void> owner) {
+    this->_offsets.assign(offsets, offsets + this->getNumberOfNodes() + 1);
+    arenaVector<int>(this->getAllocator()).swap(this->_targets);
+    this->_adjacency = targets;
+    this->_external = owner;
+}
+
+
+/**
+ * @brief Builds the reverse CSR adjacency (every node's parents) from the children, for traversals
+ *        going upwards. Does nothing if it was already built.
+ */
+template <class NodeState>
+void BasicGraph<NodeState>::buildParentAdjacency() {
+
+    if (this->hasParentAdjacency()) return;
+    int nodes = this->getNumberOfNodes();
+
+    /* Counts every node's parents into the position after it, then turns the counts into offsets */
+    this->_parentOffsets.assign(nodes + 1, 0);
+    for (int node = 1; node <= nodes; node++)
+        for (int child : this->getAdjacentNodes(node)) this->_parentOffsets[child]++;
+    for (int node = 1; node <= nodes; node++)
+        this->_parentOffsets[node] += this->_parentOffsets[node-1];
+
+    /* Walking parents in increasing order leaves every node's parents sorted */
+    arenaVector<size_t> cursor(this->_parentOffsets.begin(), this->_parentOffsets.end() - 1,
+                               this->getAllocator());
+    this->_parents.resize(this->_parentOffsets.back());
+    for (int node = 1; node <= nodes; node++)
+        for (int child : this->getAdjacentNodes(node)) this->_parents[cursor[child-1]++] = node;
+
+}
+
+
+/**
+ * @brief Performs an iterative DFS traversal of this graph starting from first node (1). Every node
+ *        being visited keeps a frame with the next child to look at, so the auxiliary stack never
+ *        holds more than one frame per node. Reaching a grey node (a back edge) marks the graph as
+ *        cyclic, in which case the order is not valid.
  *
  * @return list with nodes in topological order
  */
-deque<int> Graph::dfs() {
+template <class NodeState>
+topologicalOrder BasicGraph<NodeState>::dfs() {
 
-    /* Holds nodes that we are visiting or are about to visit */
-    deque<int> dfsAux;
+    /* Holds a frame for every node that is being visited (grey), from the oldest to the newest.
+     * It mimics what a recursion would have done */
+    arenaVector<dfsFrameStruct> dfsAux(this->getAllocator());
 
     /* Holds nodes that have been already visited in topological order */
-    deque<int> topological;
+    topologicalOrder topological(this->getAllocator());
+
+    this->_peakDfsAuxSize = 0;
+    this->_hasCycle = false;
 
     /* Visits each node (domino piece) in our graph */
     for (int parent = 1; parent <= this->getNumberOfNodes(); parent++) {
 
-        /* If it has not been yet visited, we put it inside our dfs aux */
-        if (this->getNodeInfo(parent).color == Color::white)
-            dfsAux.push_front(parent);
+        /* If it has not been yet visited, we start visiting it */
+        if (this->getNodeColor(parent) != Color::white) continue;
+        this->setNodeColor(parent, Color::grey);
+        dfsAux.emplace_back(parent, this->getAdjacentNodes(parent));
+        this->_peakDfsAuxSize = max(this->_peakDfsAuxSize, dfsAux.size());
+        STATS_ADD(dfsPushes, 1);
 
-        /* We keep visiting node until all the nodes have turned black (fully visited) */
+        /* We keep visiting nodes until every node reached from parent has turned black */
         while (!dfsAux.empty()) {
 
-            /* Gets last node being put inside our auxiliary. It mimics what a recursion
-             * would have done */
-            int node = dfsAux.front();
+            dfsFrameStruct& frame = dfsAux.back();
+
+            /* Skips children which have already been reached. A grey one is still being visited,
+             * so it leads back to itself through this node */
+            for (; frame.next != frame.last; frame.next++) {
+                Color color = this->getNodeColor(*frame.next);
+                if (color == Color::white) break;
+                if (color == Color::grey) this->_hasCycle = true;
+            }
 
-            /* If we have already visited everything from this node, we put it in our topological
-             * stack and go to next iteration */
-            if (this->getNodeInfo(node).color == Color::black) {
-                dfsAux.pop_front();
-                topological.push_front(node);
+            /* If we have already visited everything from this node, it has finished and goes into
+             * our topological stack */
+            if (frame.next == frame.last) {
+                this->setNodeColor(frame.node, Color::black);
+                topological.push_front(frame.node);
+                STATS_ADD(dfsVisits, 1);
+                dfsAux.pop_back();
                 continue;
             }
 
-            /* Since we are about to visit each child from this node, we set it as grey */
-            this->setNodeColor(node, Color::grey);
+            /* Otherwise we go down into the next child. The frame reference is not used after this
+             * since the push may move it */
+            int son = *frame.next++;
+            this->setNodeColor(son, Color::grey);
+            dfsAux.emplace_back(son, this->getAdjacentNodes(son));
+            this->_peakDfsAuxSize = max(this->_peakDfsAuxSize, dfsAux.size());
+            STATS_ADD(dfsPushes, 1);
+
+        }
+
+    }
+
+    return topological;
+}
+
 
-            /* Puts every not yet visited child node inside aux */
-            for (auto son : this->getAdjacentNodes(node))
-                if(this->getNodeInfo(son).color == Color::white)
-                    dfsAux.push_front(son);
+/**
+ * @brief Finds the strongly connected components with an iterative Tarjan, going through the nodes
+ *        as dfs() does. Every node is left black and, like dfs(), reaching a grey node marks the
+ *        graph as cyclic.
+ *
+ * @return every component's nodes, closed components first (reverse topological order)
+ */
+template <class NodeState>
+componentsStruct BasicGraph<NodeState>::components() {
+
+    int nodes = this->getNumberOfNodes();
+    componentsStruct components(this->getAllocator());
+
+    /* Colors tell apart nodes not reached yet (white), in a component still open (grey) and in a
+     * closed one (black), so most edges only look at the packed colors. Grey nodes keep the index
+     * they were discovered with, which black ones swap for their component */
+    arenaVector<int>& index = components.component;
+    index.assign(nodes, 0);
+    for (int node = 1; node <= nodes; node++) this->setNodeColor(node, Color::white);
+
+    /* Holds the frames of the nodes being visited, as dfs() does, and the visited nodes waiting
+     * for their component to close */
+    arenaVector<componentFrameStruct> frames(this->getAllocator());
+    arenaVector<int> waiting(this->getAllocator());
+
+    components.members.reserve(nodes);
+    components.start.reserve(nodes + 1);
+
+    this->_peakDfsAuxSize = 0;
+    this->_hasCycle = false;
+    int discovered = 0;
+
+    for (int root = 1; root <= nodes; root++) {
+
+        if (this->getNodeColor(root) != Color::white) continue;
+        this->setNodeColor(root, Color::grey);
+        index[root-1] = ++discovered;
+        frames.emplace_back(root, discovered, this->getAdjacentNodes(root));
+        this->_peakDfsAuxSize = max(this->_peakDfsAuxSize, frames.size());
+        STATS_ADD(dfsPushes, 1);
+
+        while (!frames.empty()) {
+
+            componentFrameStruct& frame = frames.back();
+
+            /* Skips children which have already been reached. A grey one belongs to this node's
+             * component, which is therefore a cycle, and its index may lower the low link */
+            for (; frame.next != frame.last; frame.next++) {
+                int child = *frame.next;
+                Color color = this->getNodeColor(child);
+                if (color == Color::white) break;
+                if (color == Color::grey) {
+                    this->_hasCycle = true;
+                    frame.low = min(frame.low, index[child-1]);
+                }
+            }
+
+            /* Goes down into the next child. The frame reference is not used after this since the
+             * push may move it */
+            if (frame.next != frame.last) {
+                int child = *frame.next++;
+                this->setNodeColor(child, Color::grey);
+                index[child-1] = ++discovered;
+                frames.emplace_back(child, discovered, this->getAdjacentNodes(child));
+                this->_peakDfsAuxSize = max(this->_peakDfsAuxSize, frames.size());
+                STATS_ADD(dfsPushes, 1);
+                continue;
+            }
 
-            /* Since we have put all it's children inside the aux, it has finished */
-            this->setNodeColor(node, Color::black);
+            componentFrameStruct closed = frame;
+            frames.pop_back();
+            STATS_ADD(dfsVisits, 1);
+
+            /* A node reaching nothing discovered before it closes a component with every waiting
+             * node discovered after it. Otherwise it waits as well and its parent reaches as far */
+            if (closed.low == closed.index) {
+                int id = components.start.size();
+                components.start.push_back(components.members.size());
+                while (!waiting.empty() && index[waiting.back()-1] > closed.index) {
+                    index[waiting.back()-1] = id;
+                    this->setNodeColor(waiting.back(), Color::black);
+                    components.members.push_back(waiting.back());
+                    waiting.pop_back();
+                }
+                index[closed.node-1] = id;
+                this->setNodeColor(closed.node, Color::black);
+                components.members.push_back(closed.node);
+            } else {
+                waiting.push_back(closed.node);
+                frames.back().low = min(frames.back().low, closed.low);
+            }
 
         }
 
     }
 
-    return topological;
+    components.start.push_back(components.members.size());
+
+    return components;
 }
+
+
+/* Every node state layout a graph can be built with */
+template class BasicGraph<PackedNodeState>;
+template class BasicGraph<InterleavedNodeState>;
@@ -3,6 +3,7 @@
 
 #include <bits/stdc++.h>
 #include <string>
+#include "arena.h"
 #define NEGATIVE_INFINITY INT_MIN
 
 
@@ -39,26 +40,350 @@ typedef struct nodeInfoStruct {
 
 
 /**
- * @brief Represents a Directed Acyclic Graph. Uses adjacency list.
+ * @brief Node state kept as one nodeInfoStruct per node (array of structs). Any access to a node
+ *        brings all of its fields into cache. Nodes are given by their position (node - 1).
  */
-class Graph {
+class InterleavedNodeState {
+
+    private:
+
+        /**
+         * @brief Holds every node's info, one record per node.
+         */
+        arenaVector<nodeInfoStruct> _nodeInfo;
+
+    public:
+
+        /**
+         * @brief InterleavedNodeState constructor.
+         *
+         * @param nodes number of nodes
+         * @param edges upper bound on the number of edges. Unused by this layout
+         * @param allocator where the records are allocated (the heap by default)
+         */
+        InterleavedNodeState(int nodes, size_t,
+                             ArenaAllocator<int> allocator = ArenaAllocator<int>())
+            : _nodeInfo(nodes, nodeInfoStruct(), allocator) {};
+
+        /**
+         * @brief Brings every node back to its initial state, keeping the memory already held.
+         *
+         * @param nodes number of nodes
+         * @param edges upper bound on the number of edges. Unused by this layout
+         */
+        void reset(int nodes, size_t) { this->_nodeInfo.assign(nodes, nodeInfoStruct()); };
+
+        /**
+         * @brief Makes room for in degrees bounded by a larger number of edges. Unused by this
+         *        layout, where in degrees always take a full int.
+         *
+         * @param edges new upper bound on the number of edges
+         */
+        void growEdgeBound(size_t) {};
+
+        nodeInfoStruct getInfo(int index) const { return this->_nodeInfo[index]; };
+        Color getColor(int index) const { return this->_nodeInfo[index].color; };
+        int getInDegree(int index) const { return this->_nodeInfo[index].inDegree; };
+        int getDistance(int index) const { return this->_nodeInfo[index].dist; };
+        int* getDistances() { return nullptr; };
+        void setColor(int index, Color color) { this->_nodeInfo[index].color = color; };
+        void setInDegree(int index, int inDegree) { this->_nodeInfo[index].inDegree = inDegree; };
+        void setDistance(int index, int dist) { this->_nodeInfo[index].dist = dist; };
+
+};
+
+
+/**
+ * @brief Node state kept as one array per field (struct of arrays), so loops touching one field
+ *        only bring that field into cache. Colors take 2 bits each, packed 32 to a word, and in
+ *        degrees take 16 bits whenever the graph cannot have more than 65535 edges. Nodes are
+ *        given by their position (node - 1).
+ */
+class PackedNodeState {
+
+    private:
+
+        /**
+         * @brief Holds every node's color, 2 bits each. Node i uses bits 2 * (i % 32) onwards of
+         *        word i / 32. Words are written whole, so two threads may not set colors of nodes
+         *        sharing a word at once.
+         */
+        arenaVector<uint64_t> _colors;
+
+        /**
+         * @brief Holds every node's in degree when they all fit in 16 bits.
+         */
+        arenaVector<uint16_t> _narrowInDegrees;
+
+        /**
+         * @brief Holds every node's in degree otherwise.
+         */
+        arenaVector<uint32_t> _wideInDegrees;
+
+        /**
+         * @brief Holds every node's distance.
+         */
+        arenaVector<int> _dist;
+
+        /**
+         * @brief Holds whether in degrees are kept in _wideInDegrees.
+         */
+        bool _wide;
+
+    public:
+
+        /**
+         * @brief PackedNodeState constructor. Every node starts white, with no parents and
+         *        NEGATIVE_INFINITY distance.
+         *
+         * @param nodes number of nodes
+         * @param edges upper bound on the number of edges, which bounds every in degree
+         * @param allocator where the arrays are allocated (the heap by default)
+         */
+        PackedNodeState(int nodes, size_t edges,
+                        ArenaAllocator<int> allocator = ArenaAllocator<int>())
+            : _colors(allocator), _narrowInDegrees(allocator), _wideInDegrees(allocator),
+              _dist(allocator) {
+            this->reset(nodes, edges);
+        };
+
+        /**
+         * @brief Brings every node back to its initial state, keeping the memory already held. The
+         *        in degree width is chosen again from the new bound.
+         *
+         * @param nodes number of nodes
+         * @param edges upper bound on the number of edges, which bounds every in degree
+         */
+        void reset(int nodes, size_t edges) {
+            this->_colors.assign(((size_t) nodes + 31) / 32, 0);
+            this->_dist.assign(nodes, NEGATIVE_INFINITY);
+            this->_wide = edges > UINT16_MAX;
+            if (this->_wide) this->_wideInDegrees.assign(nodes, 0);
+            else this->_narrowInDegrees.assign(nodes, 0);
+        };
+
+        /**
+         * @brief Makes room for in degrees bounded by a larger number of edges, moving them to 32
+         *        bits once they may no longer fit in 16.
+         *
+         * @param edges new upper bound on the number of edges
+         */
+        void growEdgeBound(size_t edges) {
+            if (this->_wide || edges <= UINT16_MAX) return;
+            arenaVector<uint16_t>& narrow = this->_narrowInDegrees;
+            this->_wideInDegrees.assign(narrow.begin(), narrow.end());
+            arenaVector<uint16_t>(narrow.get_allocator()).swap(narrow);
+            this->_wide = true;
+        };
+
+        nodeInfoStruct getInfo(int index) const {
+            nodeInfoStruct info;
+            info.color = this->getColor(index);
+            info.inDegree = this->getInDegree(index);
+            info.dist = this->getDistance(index);
+            return info;
+        };
+
+        Color getColor(int index) const {
+            return (Color) ((this->_colors[index >> 5] >> ((index & 31) * 2)) & 3);
+        };
+
+        int getInDegree(int index) const {
+            return this->_wide ? this->_wideInDegrees[index] : this->_narrowInDegrees[index];
+        };
+
+        int getDistance(int index) const { return this->_dist[index]; };
+        int* getDistances() { return this->_dist.data(); };
+
+        void setColor(int index, Color color) {
+            int shift = (index & 31) * 2;
+            uint64_t& word = this->_colors[index >> 5];
+            word = (word & ~((uint64_t) 3 << shift)) | ((uint64_t) color << shift);
+        };
+
+        void setInDegree(int index, int inDegree) {
+            if (this->_wide) this->_wideInDegrees[index] = inDegree;
+            else this->_narrowInDegrees[index] = inDegree;
+        };
+
+        void setDistance(int index, int dist) { this->_dist[index] = dist; };
+
+};
+
+
+/**
+ * @brief Read-only view over a node's children inside the contiguous adjacency. Can be walked with a
+ *        range based for loop without copying anything.
+ *
+ * @param first pointer to the first child
+ * @param last pointer past the last child
+ */
+typedef struct adjacencyViewStruct {
+    const int* first;
+    const int* last;
+    adjacencyViewStruct(const int* first, const int* last) : first(first), last(last) {};
+    const int* begin() const { return first; };
+    const int* end() const { return last; };
+    size_t size() const { return last - first; };
+    bool empty() const { return first == last; };
+} adjacencyViewStruct;
+
+
+/**
+ * @brief Holds a node being visited by the DFS together with the next child to look at.
+ *
+ * @param node node being visited
+ * @param next next child to look at
+ * @param last pointer past the node's last child
+ */
+typedef struct dfsFrameStruct {
+    int node;
+    const int* next;
+    const int* last;
+    dfsFrameStruct(int node, adjacencyViewStruct children)
+        : node(node), next(children.begin()), last(children.end()) {};
+} dfsFrameStruct;
+
+
+/**
+ * @brief Holds a node being visited by components() together with the index it was discovered
+ *        with and the smallest index it reaches (its low link).
+ *
+ * @param node node being visited
+ * @param index index the node was discovered with
+ * @param low smallest index of a node in an open component reached from this one
+ * @param next next child to look at
+ * @param last pointer past the node's last child
+ */
+typedef struct componentFrameStruct {
+    int node;
+    int index;
+    int low;
+    const int* next;
+    const int* last;
+    componentFrameStruct(int node, int index, adjacencyViewStruct children)
+        : node(node), index(index), low(index), next(children.begin()), last(children.end()) {};
+} componentFrameStruct;
+
+
+/**
+ * @brief Holds nodes in topological order. Drawn from the graph's arena when it has one.
+ */
+typedef deque<int, ArenaAllocator<int>> topologicalOrder;
+
+
+/**
+ * @brief Holds the strongly connected components of a graph. Drawn from the graph's arena when it
+ *        has one.
+ *
+ * @param members nodes grouped by component, components in reverse topological order
+ * @param start position in members where each component starts, plus the end of the last one
+ * @param component every node's component, given by its position in start
+ */
+typedef struct componentsStruct {
+    arenaVector<int> members;
+    arenaVector<int> start;
+    arenaVector<int> component;
+    componentsStruct(ArenaAllocator<int> allocator)
+        : members(allocator), start(allocator), component(allocator) {};
+} componentsStruct;
+
+
+/**
+ * @brief Holds the answer to the domino problem.
+ *
+ * @param interventions number of pieces that have to be pushed so that every piece falls
+ * @param sequence number of pieces in the longest sequence of falling pieces
+ */
+typedef struct dominoResultStruct {
+    int interventions;
+    int sequence;
+} dominoResultStruct;
+
+
+/**
+ * @brief Represents a Directed Acyclic Graph. Uses a Compressed Sparse Row (CSR) adjacency: one
+ *        offsets array plus one contiguous array with every node's children.
+ *
+ * @tparam NodeState how every node's color, in degree and distance are laid out in memory
+ *         (PackedNodeState or InterleavedNodeState)
+ */
+template <class NodeState>
+class BasicGraph {
     
     private:
 
         /**
          * @brief Holds all the info related to the key node after DFS traversal.
          */
-        vector<nodeInfoStruct> _nodeInfo;
+        NodeState _nodeInfo;
+
+        /**
+         * @brief Holds where each node's children start inside _targets. Node n's children live in
+         *        [_offsets[n-1], _offsets[n]). While edges are still being added, _offsets[n] holds
+         *        node n's out degree instead.
+         */
+        arenaVector<size_t> _offsets;
+
+        /**
+         * @brief Holds all the nodes which each node leads to, stored contiguously per parent.
+         */
+        arenaVector<int> _targets;
+
+        /**
+         * @brief Points to the children actually used by the adjacency accessors. It is either
+         *        _targets' memory or external memory kept alive by _external.
+         */
+        const int* _adjacency;
+
+        /**
+         * @brief Keeps external adjacency memory (e.g. a mapped binary graph) alive while in use.
+         */
+        shared_ptr<const void> _external;
+
+        /**
+         * @brief Holds the (parent, child) edge stream received by addEdge until the adjacency is
+         *        built.
+         */
+        arenaVector<pair<int, int>> _pendingEdges;
 
         /**
-         * @brief Holds all the nodes which this node leads to.
+         * @brief Holds the next free position inside _targets of each node while the adjacency is
+         *        being filled. Only allocated between allocateAdjacency and the last placeEdge.
          */
-        vector<list<int>> _adjacent;
+        arenaVector<size_t> _cursor;
+
+        /**
+         * @brief Holds where each node's parents start inside _parents, as _offsets does for
+         *        children. Empty until buildParentAdjacency is called.
+         */
+        arenaVector<size_t> _parentOffsets;
+
+        /**
+         * @brief Holds all the nodes leading to each node, stored contiguously per child.
+         */
+        arenaVector<int> _parents;
+
+        /**
+         * @brief Holds the arena every buffer and the traversals' scratch space are drawn from,
+         *        nullptr to use the heap.
+         */
+        shared_ptr<Arena> _arena;
 
         /**
          * @brief Holds number of vertices inside this graph.
          */
         int _numberOfNodes;
+
+        /**
+         * @brief Holds the most frames the last dfs() ever held at once.
+         */
+        size_t _peakDfsAuxSize;
+
+        /**
+         * @brief Holds whether a traversal found the pieces' placement to have a cycle.
+         */
+        bool _hasCycle;
     
     public:
 
@@ -66,24 +391,93 @@ class Graph {
          * @brief Graph constructor.
          *
          * @param nodes number of nodes inside graph
+         * @param edges upper bound on the number of edges, used to size the in degrees
+         * @param arena where every buffer is allocated, nullptr to use the heap
          */
-        explicit Graph(int nodes);
+        explicit BasicGraph(int nodes, size_t edges = INT_MAX, shared_ptr<Arena> arena = nullptr);
+
+        /**
+         * @brief Graphs own large buffers, so they can only be moved around, never copied.
+         */
+        BasicGraph(BasicGraph&&) = default;
+        BasicGraph& operator=(BasicGraph&&) = default;
+        BasicGraph(const BasicGraph&) = delete;
+        BasicGraph& operator=(const BasicGraph&) = delete;
+
+        /**
+         * @brief Empties this graph and gives it a new number of nodes, as if it had just been
+         *        constructed, but keeping every buffer's memory so that many graphs of similar size
+         *        can be built one after the other without allocating again. With an arena, the
+         *        arena is rewound instead, so nothing drawn from it before may be used anymore.
+         *
+         * @param nodes number of nodes inside graph
+         * @param edges upper bound on the number of edges, used to size the in degrees
+         */
+        void reset(int nodes, size_t edges = INT_MAX);
 
         /**
          * @brief Get the Node Info object.
          * 
          * @param node node value
-         * @return nodeInfoStruct related to this node
+         * @return copy of every field related to this node
          */
-        nodeInfoStruct getNodeInfo(int node);
+        nodeInfoStruct getNodeInfo(int node) const;
+
+        /**
+         * @brief Get the Node Color object.
+         *
+         * @param node node value
+         * @return node's current color
+         */
+        Color getNodeColor(int node) const;
+
+        /**
+         * @brief Get the Node In Degree object.
+         *
+         * @param node node value
+         * @return number of edges leading to this node
+         */
+        int getNodeInDegree(int node) const;
+
+        /**
+         * @brief Get the Node Distance object.
+         *
+         * @param node node value
+         * @return node's current distance
+         */
+        int getNodeDistance(int node) const;
+
+        /**
+         * @brief Get the Node Distances object. Lets vectorized loops read and write distances
+         *        directly.
+         *
+         * @return every node's distance, node n at position n - 1, or nullptr if the node state
+         *         layout does not keep them contiguous
+         */
+        int* getNodeDistances();
 
         /**
          * @brief Get the Adjacent Nodes object.
          * 
          * @param node node value
-         * @return list<int> representing a list of connected nodes
+         * @return view over this node's children inside the contiguous adjacency
+         */
+        adjacencyViewStruct getAdjacentNodes(int node) const;
+
+        /**
+         * @brief Get the Parent Nodes object. Only valid after buildParentAdjacency.
+         *
+         * @param node node value
+         * @return view over the nodes leading to this node
+         */
+        adjacencyViewStruct getParentNodes(int node) const;
+
+        /**
+         * @brief Tells whether the parent adjacency was built.
+         *
+         * @return true if getParentNodes can be used
          */
-        list<int> getAdjacentNodes(int node);
+        bool hasParentAdjacency() const;
 
         /**
          * @brief Get the Number of Nodes object.
@@ -92,6 +486,45 @@ class Graph {
          */
         int getNumberOfNodes() const;
 
+        /**
+         * @brief Get the Peak Dfs Aux Size object.
+         *
+         * @return most frames the last dfs() ever held at once
+         */
+        size_t getPeakDfsAuxSize() const;
+
+        /**
+         * @brief Tells whether a traversal found a cycle. Only valid once dfs() or any other
+         *        topological sort ran.
+         *
+         * @return true if some piece, directly or not, makes itself fall
+         */
+        bool hasCycle() const;
+
+        /**
+         * @brief Get the Allocator object.
+         *
+         * @return allocator drawing from this graph's arena (the heap if it has none). Used for
+         *         scratch space that should live as long as the graph's current contents
+         */
+        ArenaAllocator<int> getAllocator() const;
+
+        /**
+         * @brief Get the Arena Bytes object.
+         *
+         * @param nodes number of nodes
+         * @param edges number of edges
+         * @return bytes a graph of this size draws from its arena, including one traversal
+         */
+        static size_t getArenaBytes(int nodes, size_t edges);
+
+        /**
+         * @brief Get the Number of Edges object. Only valid once the adjacency is built.
+         *
+         * @return number of edges
+         */
+        size_t getNumberOfEdges() const;
+
         /**
          * @brief Changes node's current color.
          * 
@@ -100,6 +533,12 @@ class Graph {
          */
         void setNodeColor(int node, Color color);
 
+        /**
+         * @brief Records that a traversal found a cycle, so that solvers needing a topological
+         *        order hand the graph over to the components solver.
+         */
+        void markCycle();
+
         /**
          * @brief Increments node's total in degree value.
          *
@@ -107,6 +546,14 @@ class Graph {
          */
         void incrementNodeInDegree(int node);
 
+        /**
+         * @brief Changes node's total in degree value.
+         *
+         * @param node node to be changed
+         * @param inDegree new in degree
+         */
+        void setNodeInDegree(int node, int inDegree);
+
         /**
          * @brief Changes node's distance.
          *
@@ -116,21 +563,139 @@ class Graph {
         void setNodeDistance(int node, int dist);
 
         /**
-         * @brief Inserts a new edge from parent to child node.
+         * @brief Raises the upper bound on the number of edges given at construction, so that in
+         *        degrees keep fitting when edges are added to an already built graph.
+         *
+         * @param edges new upper bound on the number of edges
+         */
+        void growEdgeBound(size_t edges);
+
+        /**
+         * @brief Reserves space for the edge stream. Avoids regrowing it when the number of edges is
+         *        known beforehand.
+         *
+         * @param edges number of edges that are going to be added
+         */
+        void reserveEdges(size_t edges);
+
+        /**
+         * @brief Inserts a new edge from parent to child node. The edge only becomes visible through
+         *        the adjacency accessors after buildAdjacency is called.
          * 
          * @param parent parent's node
          * @param child child's node
          */
         void addEdge(int parent, int child);
 
+        /**
+         * @brief Builds the CSR adjacency from every edge added so far. Out degrees were already
+         *        counted by addEdge, so this turns them into offsets and fills each node's children.
+         */
+        void buildAdjacency();
+
+        /**
+         * @brief First pass of a two pass construction. Counts an edge's out and in degrees without
+         *        keeping the edge itself, for callers that can replay their edge stream.
+         *
+         * @param parent parent's node
+         * @param child child's node
+         */
+        void countEdge(int parent, int child);
+
+        /**
+         * @brief Turns the counted out degrees into offsets and allocates the contiguous adjacency.
+         *        Must be called between the countEdge and placeEdge passes.
+         */
+        void allocateAdjacency();
+
+        /**
+         * @brief Second pass of a two pass construction. Places a previously counted edge right
+         *        after its parent's other children.
+         *
+         * @param parent parent's node
+         * @param child child's node
+         */
+        void placeEdge(int parent, int child);
+
+        /**
+         * @brief Ends a two pass construction by releasing the memory used while filling.
+         */
+        void finishAdjacency();
+
+        /**
+         * @brief Counts many edges of a node at once, as countEdge would have done one by one. Used
+         *        to merge degrees counted elsewhere (e.g. by parallel loaders).
+         *
+         * @param node node to be changed
+         * @param outDegree number of edges leaving this node
+         * @param inDegree number of edges reaching this node
+         */
+        void addNodeDegrees(int node, size_t outDegree, int inDegree);
+
+        /**
+         * @brief Get the Adjacency Start object. Only valid after allocateAdjacency.
+         *
+         * @param node node value
+         * @return position inside the contiguous adjacency where this node's children start
+         */
+        size_t getAdjacencyStart(int node) const;
+
+        /**
+         * @brief Places a child at an exact position of the contiguous adjacency. Different threads
+         *        may call it at the same time as long as they write different positions.
+         *
+         * @param position position inside the contiguous adjacency
+         * @param child child's node
+         */
+        void placeEdgeAt(size_t position, int child);
+
+        /**
+         * @brief Uses an adjacency stored elsewhere instead of building one. The children are not
+         *        copied, so loading a graph costs only the pages actually touched.
+         *
+         * @param offsets nodes + 1 offsets, with the same meaning as after buildAdjacency
+         * @param targets every node's children, stored contiguously per parent
+         * @param owner keeps targets' memory alive while this graph uses it
+         */
+        void attachAdjacency(const size_t* offsets, const int* targets, shared_ptr<const void> owner);
+
+        /**
+         * @brief Builds the reverse CSR adjacency (every node's parents) from the children, for
+         *        traversals going upwards. Does nothing if it was already built.
+         */
+        void buildParentAdjacency();
+
         /**
          * @brief Performs an iterative DFS traversal of this graph starting from first node (1).
+         *        Every node being visited keeps a frame with the next child to look at, so the
+         *        auxiliary stack never holds more than one frame per node. Reaching a grey node
+         *        (a back edge) marks the graph as cyclic, in which case the order is not valid.
          *
          * @return deque with nodes in topological order
          */
-        deque<int> dfs();
+        topologicalOrder dfs();
+
+        /**
+         * @brief Finds the strongly connected components with an iterative Tarjan, going through
+         *        the nodes as dfs() does. Every node is left black and, like dfs(), reaching a grey
+         *        node marks the graph as cyclic.
+         *
+         * @return every component's nodes, closed components first (reverse topological order)
+         */
+        componentsStruct components();
 
 };
 
 
+/**
+ * @brief Graph used by every solver. Building with -DDOMINO_INTERLEAVED_NODES brings back one
+ *        record per node, e.g. to compare both layouts.
+ */
+#ifdef DOMINO_INTERLEAVED_NODES
+typedef BasicGraph<InterleavedNodeState> Graph;
+#else
+typedef BasicGraph<PackedNodeState> Graph;
+#endif
+
+
 #endif // GRAPH_H
@@ -0,0 +1,354 @@
+#include "incrementalSolver.h"
+#include "kahnSolver.h"
+#include "stats.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief IncrementalSolver constructor. Solves the graph from scratch once.
+ *
+ * @param graph graph to be kept up to date. Must have its adjacency built and no cycles
+ */
+IncrementalSolver::IncrementalSolver(Graph* graph)
+    : _graph(graph), _removedNodes(graph->getNumberOfNodes(), false),
+      _edges(graph->getNumberOfEdges()), _longest(1), _visitedBy(graph->getNumberOfNodes(), 0),
+      _visit(0) {
+
+    /* Kahn's sweep leaves every node's final distance in the graph */
+    dominoResultStruct result = solveWithKahn(graph);
+    this->_interventions = result.interventions;
+
+    /* Distances are used as a topological potential, which only exists without cycles */
+    if (graph->hasCycle()) {
+        cerr << "incremental updates need pieces placed without cycles" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /* Counts how many nodes ended up at each distance */
+    for (int node = 1; node <= graph->getNumberOfNodes(); node++) {
+        int dist = graph->getNodeDistance(node);
+        if ((int) this->_distances.size() <= dist) this->_distances.resize(dist + 1, 0);
+        this->_distances[dist]++;
+        this->_longest = max(this->_longest, dist);
+    }
+
+}
+
+
+/**
+ * @brief Changes a node's distance, keeping the count of nodes per distance.
+ *
+ * @param node node to be changed
+ * @param dist new distance
+ */
+void IncrementalSolver::setDistance(int node, int dist) {
+
+    this->_distances[this->_graph->getNodeDistance(node)]--;
+    if ((int) this->_distances.size() <= dist) this->_distances.resize(dist + 1, 0);
+    this->_distances[dist]++;
+    this->_longest = max(this->_longest, dist);
+
+    this->_graph->setNodeDistance(node, dist);
+    STATS_ADD(distanceUpdates, 1);
+
+}
+
+
+/**
+ * @brief Gets a node's current children: built ones that were not removed, then inserted ones.
+ *
+ * @param node node value
+ * @param children where the children are stored (cleared first)
+ */
+void IncrementalSolver::getChildren(int node, vector<int>& children) const {
+
+    adjacencyViewStruct built = this->_graph->getAdjacentNodes(node);
+    children.assign(built.begin(), built.end());
+
+    /* Every removed copy takes one matching child out */
+    auto removed = this->_removedChildren.find(node);
+    if (removed != this->_removedChildren.end()) {
+        for (int child : removed->second) {
+            auto found = find(children.begin(), children.end(), child);
+            *found = children.back();
+            children.pop_back();
+        }
+    }
+
+    auto inserted = this->_insertedChildren.find(node);
+    if (inserted != this->_insertedChildren.end())
+        children.insert(children.end(), inserted->second.begin(), inserted->second.end());
+
+}
+
+
+/**
+ * @brief Gets a node's current parents, as getChildren does for children. Only valid once the
+ *        graph's parent adjacency was built.
+ *
+ * @param node node value
+ * @param parents where the parents are stored (cleared first)
+ */
+void IncrementalSolver::getParents(int node, vector<int>& parents) const {
+
+    adjacencyViewStruct built = this->_graph->getParentNodes(node);
+    parents.assign(built.begin(), built.end());
+
+    auto removed = this->_removedParents.find(node);
+    if (removed != this->_removedParents.end()) {
+        for (int parent : removed->second) {
+            auto found = find(parents.begin(), parents.end(), parent);
+            *found = parents.back();
+            parents.pop_back();
+        }
+    }
+
+    auto inserted = this->_insertedParents.find(node);
+    if (inserted != this->_insertedParents.end())
+        parents.insert(parents.end(), inserted->second.begin(), inserted->second.end());
+
+}
+
+
+/**
+ * @brief Raises a node's distance, queueing it to raise its own children the first time.
+ *
+ * @param node node to be raised
+ * @param dist new distance
+ */
+void IncrementalSolver::raise(int node, int dist) {
+
+    /* Nodes are queued by the distance they had before this insertion, which never changes */
+    if (this->_visitedBy[node-1] != this->_visit) {
+        this->_visitedBy[node-1] = this->_visit;
+        int previous = this->_graph->getNodeDistance(node);
+        this->_raised.emplace_back(node, previous);
+        this->_pending.emplace(previous, node);
+    }
+
+    this->setDistance(node, dist);
+
+}
+
+
+/**
+ * @brief Raises child to dist and every node downstream whose distance depends on it.
+ *
+ * @param parent parent of the inserted edge. Reaching it means there is a cycle
+ * @param child child of the inserted edge
+ * @param dist child's new distance
+ * @return false if parent was reached, after putting every distance back
+ */
+bool IncrementalSolver::propagate(int parent, int child, int dist) {
+
+    this->_visit++;
+    this->_raised.clear();
+    this->raise(child, dist);
+
+    vector<int> children;
+    bool cycle = false;
+    while (!this->_pending.empty() && !cycle) {
+
+        int node = this->_pending.top().second;
+        this->_pending.pop();
+        int childDist = this->_graph->getNodeDistance(node) + 1;
+
+        this->getChildren(node, children);
+        STATS_ADD(edgesRelaxed, children.size());
+
+        for (size_t i = 0; i < children.size() && !cycle; i++) {
+            int next = children[i];
+            if (this->_graph->getNodeDistance(next) >= childDist) continue;
+            if (next == parent) cycle = true;
+            else this->raise(next, childDist);
+        }
+
+    }
+
+    if (!cycle) return true;
+
+    /* Puts back every distance raised by this insertion */
+    while (!this->_pending.empty()) this->_pending.pop();
+    for (const auto& raised : this->_raised) this->setDistance(raised.first, raised.second);
+
+    return false;
+
+}
+
+
+/**
+ * @brief Recomputes the distance of every node downstream of a removed edge.
+ */
+void IncrementalSolver::recompute() {
+
+    if (this->_dirty.empty()) return;
+
+    /* Gathers every node reachable from a removed edge's child. Nothing else can have changed */
+    this->_visit++;
+    vector<int> region, neighbors;
+    for (int node : this->_dirty) {
+        if (this->_visitedBy[node-1] == this->_visit) continue;
+        this->_visitedBy[node-1] = this->_visit;
+        region.push_back(node);
+    }
+    for (size_t i = 0; i < region.size(); i++) {
+        this->getChildren(region[i], neighbors);
+        for (int child : neighbors) {
+            if (this->_visitedBy[child-1] == this->_visit) continue;
+            this->_visitedBy[child-1] = this->_visit;
+            region.push_back(child);
+        }
+    }
+    this->_dirty.clear();
+
+    /* Distances are still a topological order, so every parent inside the region is recomputed
+     * before its children. Parents outside of it already have their exact distance */
+    sort(region.begin(), region.end(), [this](int first, int second) {
+        return this->_graph->getNodeDistance(first) < this->_graph->getNodeDistance(second);
+    });
+    for (int node : region) {
+        int dist = 1;
+        this->getParents(node, neighbors);
+        STATS_ADD(edgesRelaxed, neighbors.size());
+        for (int parent : neighbors) dist = max(dist, this->_graph->getNodeDistance(parent) + 1);
+        if (dist != this->_graph->getNodeDistance(node)) this->setDistance(node, dist);
+    }
+
+}
+
+
+/**
+ * @brief Inserts an edge and brings the answer up to date, repropagating distances only through the
+ *        nodes whose longest sequence actually grew.
+ *
+ * @param parent parent's node
+ * @param child child's node
+ * @return false if the edge would close a cycle or touches a removed node, in which case nothing is
+ *         changed
+ */
+bool IncrementalSolver::insertEdge(int parent, int child) {
+
+    if (parent == child || this->isNodeRemoved(parent) || this->isNodeRemoved(child)) return false;
+
+    /* Child only moves when it no longer comes after parent */
+    int dist = this->_graph->getNodeDistance(parent) + 1;
+    if (this->_graph->getNodeDistance(child) < dist && !this->propagate(parent, child, dist))
+        return false;
+
+    this->_insertedChildren[parent].push_back(child);
+    this->_insertedParents[child].push_back(parent);
+    this->_edges++;
+
+    /* Child can no longer start a sequence on its own */
+    this->_graph->growEdgeBound(this->_edges);
+    if (this->_graph->getNodeInDegree(child) == 0) this->_interventions--;
+    this->_graph->incrementNodeInDegree(child);
+
+    return true;
+
+}
+
+
+/**
+ * @brief Removes one copy of an edge. Distances are only brought up to date by getResult.
+ *
+ * @param parent parent's node
+ * @param child child's node
+ * @return false if there is no such edge
+ */
+bool IncrementalSolver::removeEdge(int parent, int child) {
+
+    /* Inserted copies go first since they are cheaper to take out */
+    auto inserted = this->_insertedChildren.find(parent);
+    vector<int>::iterator found;
+    if (inserted != this->_insertedChildren.end() &&
+        (found = find(inserted->second.begin(), inserted->second.end(), child)) !=
+        inserted->second.end()) {
+
+        inserted->second.erase(found);
+        vector<int>& parents = this->_insertedParents[child];
+        parents.erase(find(parents.begin(), parents.end(), parent));
+
+    } else {
+
+        /* A built copy must be left that was not removed yet */
+        adjacencyViewStruct built = this->_graph->getAdjacentNodes(parent);
+        auto removed = this->_removedChildren.find(parent);
+        long copies = count(built.begin(), built.end(), child);
+        if (removed != this->_removedChildren.end())
+            copies -= count(removed->second.begin(), removed->second.end(), child);
+        if (copies <= 0) return false;
+
+        this->_removedChildren[parent].push_back(child);
+        this->_removedParents[child].push_back(parent);
+
+    }
+
+    this->_edges--;
+    this->_graph->buildParentAdjacency();
+
+    /* Child may become a piece that has to be pushed, and its distance may now be too large */
+    this->_graph->setNodeInDegree(child, this->_graph->getNodeInDegree(child) - 1);
+    if (this->_graph->getNodeInDegree(child) == 0) this->_interventions++;
+    this->_dirty.push_back(child);
+
+    return true;
+
+}
+
+
+/**
+ * @brief Removes a node together with every edge leading to or leaving it. The node no longer
+ *        counts as a piece and cannot be given edges again.
+ *
+ * @param node node to be removed
+ * @return false if it was already removed
+ */
+bool IncrementalSolver::removeNode(int node) {
+
+    if (this->isNodeRemoved(node)) return false;
+
+    this->_graph->buildParentAdjacency();
+    vector<int> neighbors;
+    this->getChildren(node, neighbors);
+    for (int child : neighbors) this->removeEdge(node, child);
+    this->getParents(node, neighbors);
+    for (int parent : neighbors) this->removeEdge(parent, node);
+
+    /* Left without parents, the node counted as an intervention and is no longer a piece */
+    this->_removedNodes[node-1] = true;
+    this->_interventions--;
+    this->setDistance(node, 1);
+
+    return true;
+
+}
+
+
+/**
+ * @brief Tells whether a node was removed.
+ *
+ * @param node node value
+ * @return true if it was removed
+ */
+bool IncrementalSolver::isNodeRemoved(int node) const { return this->_removedNodes[node-1]; }
+
+
+/**
+ * @brief Get the Result object. Lowers the distances left too large by removals first.
+ *
+ * @return number of interventions and longest sequence with every update applied so far
+ */
+dominoResultStruct IncrementalSolver::getResult() {
+
+    this->recompute();
+
+    /* The longest sequence is the largest distance some node still has. With no edges at all it is
+     * reported as 0, as the other solvers do */
+    while (this->_longest > 1 && this->_distances[this->_longest] == 0) this->_longest--;
+    dominoResultStruct result = {this->_interventions, this->_longest > 1 ? this->_longest : 0};
+    return result;
+
+}
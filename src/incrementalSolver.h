@@ -0,0 +1,219 @@
+#ifndef INCREMENTAL_SOLVER_H
+#define INCREMENTAL_SOLVER_H
+
+#include <queue>
+#include <unordered_map>
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Keeps the domino answer up to date while edges and nodes are inserted into or removed from
+ *        an already built graph, without solving it again. The graph's in degrees and distances are
+ *        updated in place, while inserted and removed edges are kept next to the CSR adjacency,
+ *        which cannot change.
+ *
+ *        Every node's distance doubles as a topological order: every edge leads to a node with a
+ *        larger distance. Inserting parent -> child only has to raise child when that no longer
+ *        holds, and then every node downstream whose distance depended on it. Raised nodes are
+ *        processed by their distance before the insertion, so all of a node's raised parents are
+ *        done before it and no node is processed twice. If the raise ever reaches parent, child
+ *        already led to parent and the edge would close a cycle, so it is rejected and every
+ *        distance raised so far is put back.
+ *
+ *        Removing edges keeps in degrees and interventions exact right away, but distances are
+ *        only lowered when the answer is asked for: until then they are upper bounds, which are
+ *        still a valid topological order for insertions. The nodes downstream of every removed
+ *        edge are then recomputed from their parents, in distance order.
+ */
+class IncrementalSolver {
+
+    private:
+
+        /**
+         * @brief Holds the graph being kept up to date.
+         */
+        Graph* _graph;
+
+        /**
+         * @brief Holds the children each parent was given after the graph was built.
+         */
+        unordered_map<int, vector<int>> _insertedChildren;
+
+        /**
+         * @brief Holds the parents each child was given after the graph was built.
+         */
+        unordered_map<int, vector<int>> _insertedParents;
+
+        /**
+         * @brief Holds the built children removed from each parent, once per removed copy.
+         */
+        unordered_map<int, vector<int>> _removedChildren;
+
+        /**
+         * @brief Holds the built parents removed from each child, once per removed copy.
+         */
+        unordered_map<int, vector<int>> _removedParents;
+
+        /**
+         * @brief Holds whether each node was removed.
+         */
+        vector<bool> _removedNodes;
+
+        /**
+         * @brief Holds number of edges inside the graph, including inserted ones.
+         */
+        size_t _edges;
+
+        /**
+         * @brief Holds number of nodes with in degree 0.
+         */
+        int _interventions;
+
+        /**
+         * @brief Holds how many nodes have each distance, so that the longest sequence is still
+         *        known after distances are lowered.
+         */
+        vector<int> _distances;
+
+        /**
+         * @brief Holds the largest distance any node may have. Lowered lazily by getResult.
+         */
+        int _longest;
+
+        /**
+         * @brief Holds the children of removed edges whose distance may be too large.
+         */
+        vector<int> _dirty;
+
+        /**
+         * @brief Holds, for every node, the last insertion or recomputation that visited it. Tells
+         *        nodes already visited apart without clearing anything between them.
+         */
+        vector<unsigned> _visitedBy;
+
+        /**
+         * @brief Holds the number of the current insertion or recomputation.
+         */
+        unsigned _visit;
+
+        /**
+         * @brief Holds every node raised by the current insertion with its previous distance, so
+         *        that they can be put back if the insertion is rejected.
+         */
+        vector<pair<int, int>> _raised;
+
+        /**
+         * @brief Holds raised nodes still to be processed, by their previous distance (smallest
+         *        first).
+         */
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> _pending;
+
+        /**
+         * @brief Changes a node's distance, keeping the count of nodes per distance.
+         *
+         * @param node node to be changed
+         * @param dist new distance
+         */
+        void setDistance(int node, int dist);
+
+        /**
+         * @brief Gets a node's current children: built ones that were not removed, then inserted
+         *        ones.
+         *
+         * @param node node value
+         * @param children where the children are stored (cleared first)
+         */
+        void getChildren(int node, vector<int>& children) const;
+
+        /**
+         * @brief Gets a node's current parents, as getChildren does for children. Only valid once
+         *        the graph's parent adjacency was built.
+         *
+         * @param node node value
+         * @param parents where the parents are stored (cleared first)
+         */
+        void getParents(int node, vector<int>& parents) const;
+
+        /**
+         * @brief Raises a node's distance, queueing it to raise its own children the first time.
+         *
+         * @param node node to be raised
+         * @param dist new distance
+         */
+        void raise(int node, int dist);
+
+        /**
+         * @brief Raises child to dist and every node downstream whose distance depends on it.
+         *
+         * @param parent parent of the inserted edge. Reaching it means there is a cycle
+         * @param child child of the inserted edge
+         * @param dist child's new distance
+         * @return false if parent was reached, after putting every distance back
+         */
+        bool propagate(int parent, int child, int dist);
+
+        /**
+         * @brief Recomputes the distance of every node downstream of a removed edge.
+         */
+        void recompute();
+
+    public:
+
+        /**
+         * @brief IncrementalSolver constructor. Solves the graph from scratch once.
+         *
+         * @param graph graph to be kept up to date. Must have its adjacency built and no cycles
+         */
+        explicit IncrementalSolver(Graph* graph);
+
+        /**
+         * @brief Inserts an edge and brings the answer up to date, repropagating distances only
+         *        through the nodes whose longest sequence actually grew.
+         *
+         * @param parent parent's node
+         * @param child child's node
+         * @return false if the edge would close a cycle or touches a removed node, in which case
+         *         nothing is changed
+         */
+        bool insertEdge(int parent, int child);
+
+        /**
+         * @brief Removes one copy of an edge. Distances are only brought up to date by getResult.
+         *
+         * @param parent parent's node
+         * @param child child's node
+         * @return false if there is no such edge
+         */
+        bool removeEdge(int parent, int child);
+
+        /**
+         * @brief Removes a node together with every edge leading to or leaving it. The node no
+         *        longer counts as a piece and cannot be given edges again.
+         *
+         * @param node node to be removed
+         * @return false if it was already removed
+         */
+        bool removeNode(int node);
+
+        /**
+         * @brief Tells whether a node was removed.
+         *
+         * @param node node value
+         * @return true if it was removed
+         */
+        bool isNodeRemoved(int node) const;
+
+        /**
+         * @brief Get the Result object. Lowers the distances left too large by removals first.
+         *
+         * @return number of interventions and longest sequence with every update applied so far
+         */
+        dominoResultStruct getResult();
+
+};
+
+
+#endif // INCREMENTAL_SOLVER_H
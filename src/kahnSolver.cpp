@@ -0,0 +1,79 @@
+#include "componentSolver.h"
+#include "kahnSolver.h"
+#include "stats.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Solves the domino problem in a single sweep over the edges, following Kahn's algorithm: a
+ *        node is processed once every edge leading to it has been relaxed, so its distance is final
+ *        by then. Needs no topological order, no colors and only keeps the nodes ready to be
+ *        processed. Node distances are left in the graph, like solveDominoPiecesProblem does.
+ *        Nodes on a cycle never become ready, so a graph left with some of them is marked as cyclic
+ *        and solved by solveWithComponents instead (predecessors are then left as they are).
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @param predecessors if not null, receives every node's parent in its longest sequence (0 for
+ *        nodes starting one). Must hold one entry per node
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct solveWithKahn(Graph* graph, vector<int>* predecessors) {
+
+    dominoResultStruct result = {0, 0};
+    int nodes = graph->getNumberOfNodes(), processed = 0;
+
+    /* Holds how many parents of each node have not been processed yet */
+    arenaVector<int> remaining(nodes, 0, graph->getAllocator());
+
+    /* Holds nodes whose parents have all been processed. Used as a stack, which keeps it small on
+     * deep graphs since children are processed right after their last parent */
+    vector<int> frontier;
+
+    /* Nodes with in degree 0 have to be pushed (interventions) and start every sequence */
+    for (int node = 1; node <= nodes; node++) {
+        remaining[node-1] = graph->getNodeInDegree(node);
+        if (remaining[node-1] == 0) {
+            result.interventions++;
+            graph->setNodeDistance(node, 1);
+            frontier.push_back(node);
+        } else {
+            graph->setNodeDistance(node, NEGATIVE_INFINITY);
+        }
+    }
+
+    /* Every edge is visited once: its child's distance is relaxed and, if it was the child's last
+     * unprocessed parent, the child becomes ready */
+    while (!frontier.empty()) {
+
+        int node = frontier.back(); frontier.pop_back();
+        processed++;
+        int childDist = graph->getNodeDistance(node) + 1;
+
+        adjacencyViewStruct children = graph->getAdjacentNodes(node);
+        STATS_ADD(edgesRelaxed, children.size());
+
+        for (int child : children) {
+
+            if (graph->getNodeDistance(child) < childDist) {
+                graph->setNodeDistance(child, childDist);
+                STATS_ADD(distanceUpdates, 1);
+                if (predecessors) (*predecessors)[child-1] = node;
+                if (childDist > result.sequence) result.sequence = childDist;
+            }
+
+            if (--remaining[child-1] == 0) frontier.push_back(child);
+
+        }
+
+    }
+
+    if (processed < nodes) {
+        graph->markCycle();
+        return solveWithComponents(graph);
+    }
+
+    return result;
+
+}
@@ -0,0 +1,26 @@
+#ifndef KAHN_SOLVER_H
+#define KAHN_SOLVER_H
+
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Solves the domino problem in a single sweep over the edges, following Kahn's algorithm: a
+ *        node is processed once every edge leading to it has been relaxed, so its distance is final
+ *        by then. Needs no topological order, no colors and only keeps the nodes ready to be
+ *        processed. Node distances are left in the graph, like solveDominoPiecesProblem does.
+ *        Nodes on a cycle never become ready, so a graph left with some of them is marked as cyclic
+ *        and solved by solveWithComponents instead (predecessors are then left as they are).
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @param predecessors if not null, receives every node's parent in its longest sequence (0 for
+ *        nodes starting one). Must hold one entry per node
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct solveWithKahn(Graph* graph, vector<int>* predecessors = nullptr);
+
+
+#endif // KAHN_SOLVER_H
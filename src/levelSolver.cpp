@@ -0,0 +1,139 @@
+#include <atomic>
+#include "componentSolver.h"
+#include "levelSolver.h"
+#include "parallel.h"
+#include "stats.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Number of nodes a worker claims at a time from the current level. Small enough to balance
+ *        nodes with very different out degrees, big enough to keep the shared counter cold.
+ */
+#define LEVEL_CHUNK_SIZE 64
+
+
+/**
+ * @brief Solves the domino problem level by level with several workers. Level 1 holds the nodes with
+ *        in degree 0 and a node joins the next level once its last parent was processed, so every
+ *        node's level is exactly its longest sequence distance. Nodes of the same level are processed
+ *        in parallel and only their children's remaining parents counters are shared, so the answer
+ *        is always the same as the serial solvers'. Node distances are left in the graph. Nodes on a
+ *        cycle never join a level, so a graph left with some of them is marked as cyclic and solved
+ *        by solveWithComponents instead.
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @param workers number of workers, 0 to use every hardware thread
+ * @param levels if not null, receives how every level went
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct solveWithLevels(Graph* graph, int workers, vector<levelStatsStruct>* levels) {
+
+    dominoResultStruct result = {0, 0};
+    int nodes = graph->getNumberOfNodes();
+    if (workers <= 0) workers = getDefaultWorkers();
+
+    /* Holds how many parents of each node have not been processed yet. Shared by every worker */
+    unique_ptr<atomic<int>[]> remaining(new atomic<int>[nodes]);
+
+    /* Holds the nodes of the level being processed */
+    vector<int> frontier;
+
+    /* Nodes with in degree 0 have to be pushed (interventions) and make up the first level */
+    for (int node = 1; node <= nodes; node++) {
+        remaining[node-1].store(graph->getNodeInDegree(node), memory_order_relaxed);
+        if (graph->getNodeInDegree(node) == 0) {
+            result.interventions++;
+            graph->setNodeDistance(node, 1);
+            frontier.push_back(node);
+        } else {
+            graph->setNodeDistance(node, NEGATIVE_INFINITY);
+        }
+    }
+
+    /* Holds, per worker, the nodes it made ready for the next level and the edges it relaxed */
+    vector<vector<int>> ready(workers);
+    vector<size_t> relaxed(workers);
+
+    /* Holds the position of the next chunk of the current level to be claimed */
+    atomic<size_t> claimed(0);
+
+    Barrier barrier(workers);
+    int level = 1;
+    size_t processed = frontier.size();
+    bool done = frontier.empty();
+
+    if (!done) runWorkers(workers, [&](int worker) {
+
+        while (true) {
+
+            /* Claims chunks of the current level until there are none left. The worker taking a
+             * child's last parent is the only one that sees its counter reach 0, so it alone sets
+             * the child's distance and schedules it */
+            size_t edges = 0;
+            for (size_t first; (first = claimed.fetch_add(LEVEL_CHUNK_SIZE)) < frontier.size(); ) {
+                size_t last = min(first + LEVEL_CHUNK_SIZE, frontier.size());
+                for (size_t i = first; i < last; i++) {
+                    adjacencyViewStruct children = graph->getAdjacentNodes(frontier[i]);
+                    edges += children.size();
+                    for (int child : children) {
+                        if (remaining[child-1].fetch_sub(1, memory_order_relaxed) == 1) {
+                            graph->setNodeDistance(child, level + 1);
+                            ready[worker].push_back(child);
+                        }
+                    }
+                }
+            }
+            relaxed[worker] = edges;
+
+            barrier.wait();
+
+            /* A single worker gathers the next level while the others wait */
+            if (worker == 0) {
+
+                levelStatsStruct stats = {(int) frontier.size(), 0, 0};
+                for (size_t edges : relaxed) {
+                    stats.edges += edges;
+                    stats.busiest = max(stats.busiest, edges);
+                }
+                if (levels != nullptr) levels->push_back(stats);
+
+                frontier.clear();
+                for (auto& nodes : ready) {
+                    frontier.insert(frontier.end(), nodes.begin(), nodes.end());
+                    nodes.clear();
+                }
+
+                /* Every node of the next level got its distance set exactly once */
+                STATS_ADD(edgesRelaxed, stats.edges);
+                STATS_ADD(distanceUpdates, frontier.size());
+
+                claimed.store(0);
+                processed += frontier.size();
+                level++;
+                done = frontier.empty();
+
+            }
+
+            barrier.wait();
+            if (done) break;
+
+        }
+
+    });
+
+    if (processed < (size_t) nodes) {
+        graph->markCycle();
+        return solveWithComponents(graph);
+    }
+
+    /* Every node's distance is its level, so the longest sequence is the number of levels. Like the
+     * other solvers, it only counts once some piece was toppled by another one */
+    int depth = level - 1;
+    result.sequence = depth >= 2 ? depth : 0;
+
+    return result;
+
+}
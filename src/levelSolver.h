@@ -0,0 +1,42 @@
+#ifndef LEVEL_SOLVER_H
+#define LEVEL_SOLVER_H
+
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Holds how a level of the level synchronous solver went.
+ *
+ * @param nodes number of nodes processed in this level (its width)
+ * @param edges number of edges relaxed in this level
+ * @param busiest number of edges relaxed by the busiest worker. edges / busiest tells how many
+ *        workers were effectively busy
+ */
+typedef struct levelStatsStruct {
+    int nodes;
+    size_t edges;
+    size_t busiest;
+} levelStatsStruct;
+
+
+/**
+ * @brief Solves the domino problem level by level with several workers. Level 1 holds the nodes
+ *        with in degree 0 and a node joins the next level once its last parent was processed, so
+ *        every node's level is exactly its longest sequence distance. Nodes of the same level are
+ *        processed in parallel and only their children's remaining parents counters are shared, so
+ *        the answer is always the same as the serial solvers'. Node distances are left in the graph.
+ *        Nodes on a cycle never join a level, so a graph left with some of them is marked as cyclic
+ *        and solved by solveWithComponents instead.
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @param workers number of workers, 0 to use every hardware thread
+ * @param levels if not null, receives how every level went
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct solveWithLevels(Graph* graph, int workers, vector<levelStatsStruct>* levels);
+
+
+#endif // LEVEL_SOLVER_H
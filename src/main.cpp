@@ -1,6 +1,21 @@
+#include <fcntl.h>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <unistd.h>
+#include "batch.h"
+#include "componentSolver.h"
 #include "graph.h"
+#include "incrementalSolver.h"
+#include "kahnSolver.h"
+#include "levelSolver.h"
+#include "orderSolver.h"
+#include "parallelTopological.h"
+#include "queryServer.h"
+#include "reader.h"
+#include "reduction.h"
+#include "relabel.h"
+#include "stats.h"
 
 
 using namespace std;
@@ -9,88 +24,175 @@ using namespace std;
 /**
  * @brief Creates and populates the graph that is going to represent all the pieces' placement.
  *
+ * @param workers number of threads used to parse the edges, 0 to use every hardware thread
  * @return newly created graph
  */
-Graph initGraph() {
+Graph initGraph(int workers) {
 
-    /* Receive number of nodes and vertices from cin */
-    int nNodes, nEdges;
+    /* Maps (or block reads) stdin and parses the edges straight from memory */
+    return readGraph(STDIN_FILENO, workers);
 
-    /* Hold parent and child node numbers while populating */
-    int parent, child;
-
-    /* Reads number of nodes and edges from cin */
-    cin >> nNodes >> nEdges;
+}
 
-    /* Creates graph */
-    Graph graph(nNodes);
 
-    /* Populates graph with all the edges from cin */
-    for (int i = 0; i < nEdges; i++) {
-        cin >> parent >> child;
-        graph.addEdge(parent, child);
+/**
+ * @brief Prints the longest sequences of pieces, one per line, from the piece pushed to the last
+ *        one falling. Cyclic graphs were solved on their components, which keep no predecessors.
+ *
+ * @param graph solved graph
+ * @param predecessors every node's parent in its longest sequence
+ * @param count number of sequences to print
+ * @param original if the graph was renumbered, every node's original number (empty otherwise)
+ */
+void printChains(const Graph* graph, const vector<int>& predecessors, int count,
+                 const vector<int>& original) {
+    if (graph->hasCycle()) {
+        cerr << "no chains: the pieces are placed with cycles" << endl;
+        return;
+    }
+    for (const vector<int>& chain : getLongestChains(graph, predecessors, count)) {
+        for (size_t i = 0; i < chain.size(); i++)
+            cout << (i ? " " : "") << (original.empty() ? chain[i] : original[chain[i]-1]);
+        cout << "\n";
     }
-
-    return graph;
-
 }
 
 
 /**
  * @brief Counts number os times we have to make a piece fall to traverse all the pieces (is just
- *        the amount of node with in degree 0). Also finds longest path in our graph
+ *        the amount of node with in degree 0). Also finds longest path in our graph. If sorting it
+ *        found a cycle, the order is not valid and the graph is condensed into its components.
  *
  * @param graph graph representing domino problem which will be traversed
  * @param topological stack with nodes in topological order
+ * @param predecessors if not null, receives every node's parent in its longest sequence
  */
-void solveDominoPiecesProblem(Graph* graph, deque<int>* topological) {
-
-    /* Hold the amount of times we have to make a piece fall to traverse all the pieces */
-    int interventions = 0, sequence = 0;
+void solveDominoPiecesProblem(Graph* graph, topologicalOrder* topological,
+                              vector<int>* predecessors) {
 
-    /* Counts number of nodes with in degree 0 (interventions) and sets their distance as 1. This
-     * will be used later on when we try to find the longest path */
-    for (int node = 1; node <= graph->getNumberOfNodes(); node++) {
-        if (graph->getNodeInfo(node).inDegree == 0) {
-            interventions++;
-            graph->setNodeDistance(node, 1);
-        }
-    }
+    /* Finds minimum interventions and biggest sequence following the topological order */
+    dominoResultStruct result = graph->hasCycle() ? solveWithComponents(graph)
+                                                  : solveWithOrder(graph, topological, predecessors);
 
-    /* We traverse all the nodes in our topological stack and traverse them one by one. While doing
-     * this, we traverse their children and change their distance. This will count the number of
-     * edges between them and their parents */
-    while ( ! topological->empty()) {
+    /* Outputs final result */
+    cout << result.interventions << " " << result.sequence << endl;
 
-        /* Gets node from stack */
-        int node = topological->front(); topological->pop_front();
+}
 
-        /* Traverses children sets their distance */
-        if (graph->getNodeInfo(node).dist != NEGATIVE_INFINITY) {
 
-            int parentDist = graph->getNodeInfo(node).dist;
+/**
+ * @brief Solves the graph once and then keeps the answer up to date while applying a list of
+ *        updates, one per line: "+ parent child" inserts an edge, "- parent child" removes one, "x
+ *        node" removes a node with all of its edges and "?" prints the current answer. Updates
+ *        print "ok", "cycle" when an insertion is rejected for closing one or "missing" when what
+ *        they refer to does not exist. The answer is also printed at the start.
+ *
+ * @param graph graph representing domino problem, with its adjacency built
+ * @param path file holding the updates
+ */
+void applyUpdates(Graph* graph, const string& path) {
 
-            for (auto child: graph->getAdjacentNodes(node)) {
+    ifstream updates(path);
+    if (!updates) {
+        cerr << path << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
 
-                if (graph->getNodeInfo(child).dist < parentDist + 1) {
+    IncrementalSolver solver(graph);
+    dominoResultStruct result = solver.getResult();
+    cout << result.interventions << " " << result.sequence << "\n";
 
-                    graph->setNodeDistance(child, parentDist + 1);
+    int nodes = graph->getNumberOfNodes();
+    string line, operation;
+    for (int number = 1; getline(updates, line); number++) {
 
-                    /* Finds and holds longest distance. Is done here as to avoid doing another loop
-                     * to find the highest distance */
-                    if (parentDist + 1 > sequence) sequence = parentDist + 1;
+        istringstream tokens(line);
+        if (!(tokens >> operation)) continue;
 
-                }
+        /* Distances are only brought up to date when the answer is asked for */
+        if (operation == "?") {
+            result = solver.getResult();
+            cout << result.interventions << " " << result.sequence << "\n";
+            continue;
+        }
 
-            }
+        int parent = 0, child = 0;
+        bool wellFormed = operation == "x" ? (bool) (tokens >> parent)
+                        : (operation == "+" || operation == "-") && tokens >> parent >> child;
+        if (operation == "x") child = parent;
+        if (!wellFormed || parent < 1 || parent > nodes || child < 1 || child > nodes) {
+            cerr << path << ": update " << number << ": expected \"+ parent child\", \"- parent"
+                 << " child\", \"x node\" or \"?\" with nodes in [1, " << nodes << "]" << endl;
+            exit(EXIT_FAILURE);
+        }
 
+        if (operation == "+") {
+            if (solver.isNodeRemoved(parent) || solver.isNodeRemoved(child)) cout << "missing\n";
+            else cout << (solver.insertEdge(parent, child) ? "ok\n" : "cycle\n");
         }
+        else if (operation == "-") cout << (solver.removeEdge(parent, child) ? "ok\n" : "missing\n");
+        else cout << (solver.removeNode(parent) ? "ok\n" : "missing\n");
 
     }
 
-    /* Outputs final result */
-    cout << interventions << " " << sequence << endl;
+}
+
+
+/**
+ * @brief Replaces a graph by its transitive reduction and tells on stderr how many edges it lost.
+ *        Graphs placed with cycles are left as they are (and marked as cyclic).
+ *
+ * @param graph graph to be reduced
+ * @param window how many positions before a block its parents are looked for (0 for all of them)
+ */
+void reducePlacement(Graph* graph, size_t window) {
+    size_t pruned, edges = graph->getNumberOfEdges();
+    if (reduceTransitiveEdges(graph, &pruned, window))
+        cerr << "pruned edges: " << pruned << " of " << edges << endl;
+    else cerr << "not reduced: the pieces are placed with cycles" << endl;
+}
 
+
+/**
+ * @brief Prints how to use this program and terminates it.
+ */
+void printUsage() {
+    cerr << "Usage: domino [--solver dfs|kahn|level|scc] [--order dfs|stealing] [--workers N]"
+         << " [--levels] [--reduce [--window N]] [--relabel dfs|bfs] [--chains K] [--stats]"
+         << " [--batch] [--updates FILE] [--serve GRAPH [--socket PATH] [--index-memory MB]"
+         << " [--labels K]] < problem.txt" << endl;
+    cerr << "\t--solver dfs: topological order followed by longest path (default)" << endl;
+    cerr << "\t--solver kahn: in degree driven order fused with longest path, one sweep" << endl;
+    cerr << "\t--solver level: level synchronous parallel longest path" << endl;
+    cerr << "\t--solver scc: strongly connected components condensed, each weighted by its size."
+         << " The others switch to it on cyclic inputs" << endl;
+    cerr << "\t--order dfs: topological order from the serial DFS (default)" << endl;
+    cerr << "\t--order stealing: topological order from work stealing workers" << endl;
+    cerr << "\t--workers N: number of threads used to load and solve (default: all)" << endl;
+    cerr << "\t--reduce: drops every edge implied by others before solving and prints how many on"
+         << " stderr. Pays off on dense placements or when serving (not with --batch or --updates)"
+         << endl;
+    cerr << "\t--window N: with --reduce, only drops edges whose parent is at most N positions"
+         << " before its child's block of 64 or more, which bounds the time on large sparse inputs"
+         << endl;
+    cerr << "\t--relabel dfs|bfs: renumbers the pieces in DFS or BFS topological order before"
+         << " solving, so that relaxing them sweeps memory in order" << endl;
+    cerr << "\t--chains K: also prints the K longest sequences of pieces, one per line (not with"
+         << " --solver level or scc, nor on cyclic inputs)" << endl;
+    cerr << "\t--levels: prints each level's width, edges and parallelism on stderr" << endl;
+    cerr << "\t--stats: prints each phase's wall time and the hot path counters on stderr" << endl;
+    cerr << "\t--batch: solves every instance of concatenated edge lists, one answer line each,"
+         << " with N instances at once" << endl;
+    cerr << "\t--updates FILE: keeps the answer up to date while applying FILE's updates, one per"
+         << " line: \"+ parent child\", \"- parent child\", \"x node\" or \"?\" to print it" << endl;
+    cerr << "\t--serve GRAPH: loads GRAPH once and answers query lines from stdin: \"chain node\","
+         << " \"pushers node\", \"reach node\", \"topples node node\" or \"answer\"" << endl;
+    cerr << "\t--socket PATH: with --serve, answers clients of a Unix socket instead" << endl;
+    cerr << "\t--index-memory MB: with --serve, memory the reachability bitsets may take (default:"
+         << " 256). Larger graphs get interval labels instead" << endl;
+    cerr << "\t--labels K: with --serve, interval labellings built when the bitsets do not fit"
+         << " (default: 2). More of them answer more queries without a DFS" << endl;
+    exit(EXIT_FAILURE);
 }
 
 
@@ -99,16 +201,188 @@ void solveDominoPiecesProblem(Graph* graph, deque<int>* topological) {
  *
  * @return terminate code
  */
-int main() {
+int main(int argc, char *argv[]) {
+
+    /* Holds which engine solves the problem and with how many threads */
+    string solver = "dfs", order = "dfs", relabel, updates, serve, socket;
+    int workers = 0, chains = 0;
+    size_t window = 0;
+    reachabilityOptionsStruct reachability = {REACHABILITY_MEMORY, REACHABILITY_LABELS, 0};
+    bool reportLevels = false, reportStats = false, batch = false, reduce = false;
+
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--solver" && i + 1 < argc) solver = argv[++i];
+        else if (option == "--order" && i + 1 < argc) order = argv[++i];
+        else if (option == "--workers" && i + 1 < argc) workers = atoi(argv[++i]);
+        else if (option == "--levels") reportLevels = true;
+        else if (option == "--reduce") reduce = true;
+        else if (option == "--window" && i + 1 < argc) window = strtoull(argv[++i], nullptr, 10);
+        else if (option == "--relabel" && i + 1 < argc) relabel = argv[++i];
+        else if (option == "--chains" && i + 1 < argc) chains = atoi(argv[++i]);
+        else if (option == "--stats") reportStats = true;
+        else if (option == "--batch") batch = true;
+        else if (option == "--updates" && i + 1 < argc) updates = argv[++i];
+        else if (option == "--serve" && i + 1 < argc) serve = argv[++i];
+        else if (option == "--socket" && i + 1 < argc) socket = argv[++i];
+        else if (option == "--index-memory" && i + 1 < argc)
+            reachability.memory = strtoull(argv[++i], nullptr, 10) << 20;
+        else if (option == "--labels" && i + 1 < argc) reachability.labels = atoi(argv[++i]);
+        else printUsage();
+    }
+    if (solver != "dfs" && solver != "kahn" && solver != "level" && solver != "scc") printUsage();
+    if (order != "dfs" && order != "stealing") printUsage();
+    if (!socket.empty() && serve.empty()) printUsage();
+    if (serve.empty() && (reachability.memory != REACHABILITY_MEMORY ||
+                          reachability.labels != REACHABILITY_LABELS)) printUsage();
+    if (reachability.labels < 1) printUsage();
+    if (chains < 0 || (chains > 0 && (solver == "level" || solver == "scc"))) printUsage();
+    if (!relabel.empty() && relabel != "dfs" && relabel != "bfs") printUsage();
+    if (!relabel.empty() && (batch || !updates.empty() || !serve.empty())) printUsage();
+    if (reduce && (batch || !updates.empty())) printUsage();
+    if (window > 0 && !reduce) printUsage();
+
+    /* Times every phase. Only a few clock reads, so it is always there */
+    PhaseTimer timer;
+
+    /* Solves many instances with the same buffers, keeping their order in the output */
+    if (batch) {
+        timer.start("batch");
+        solveBatch(STDIN_FILENO, solver, order, workers);
+        timer.stop();
+        if (reportStats) printStats(cerr, timer, 0);
+        exit(EXIT_SUCCESS);
+    }
+
+    /* Loads the graph once and answers as many queries as asked, so stdin is free for them */
+    if (!serve.empty()) {
+        int fd = open(serve.c_str(), O_RDONLY);
+        if (fd < 0) {
+            cerr << serve << ": " << strerror(errno) << endl;
+            exit(EXIT_FAILURE);
+        }
+        timer.start("load");
+        Graph graph = readGraph(fd, workers);
+        close(fd);
+        if (reduce) {
+            timer.start("reduce");
+            reducePlacement(&graph, window);
+        }
+
+        /* The index is built by as many workers as the graph was loaded with */
+        timer.start("index");
+        reachability.workers = workers;
+        GraphQueries queries(&graph, reachability);
+        timer.stop();
+        if (reportStats) {
+            printStats(cerr, timer, 0);
+            const ReachabilityIndex* built = queries.getIndex();
+            cerr << "reachability index: " << (built->hasBitsets() ? "bitsets" : "interval labels")
+                 << ", " << built->getBytes() << " bytes" << endl;
+        }
+
+        if (socket.empty()) serveQueries(&queries, cin, cout);
+        else serveSocket(&queries, socket);
+        exit(EXIT_SUCCESS);
+    }
 
     /* Creates and populates the graph that is going to represent all the pieces' placement */
-    Graph graph = initGraph();
+    timer.start("load");
+    Graph graph = initGraph(workers);
+
+    /* Solves once and then follows every update incrementally */
+    if (!updates.empty()) {
+        timer.start("updates");
+        applyUpdates(&graph, updates);
+        timer.stop();
+        if (reportStats) printStats(cerr, timer, 0);
+        exit(EXIT_SUCCESS);
+    }
+
+    if (reduce) {
+        timer.start("reduce");
+        reducePlacement(&graph, window);
+    }
 
-    /* Performs a DFS and returns an array with all the vertices inversely sorted by finish time */
-    deque<int> topological = graph.dfs();
+    /* Renumbers the pieces so that related ones are close in memory. Only chains print pieces,
+     * and they are mapped back to their original numbers */
+    vector<int> original;
+    if (!relabel.empty()) {
+        timer.start("relabel");
+        original = getRelabelOrder(&graph, relabel);
+        bool cyclic = graph.hasCycle();
+        graph = relabelGraph(&graph, original);
+        if (cyclic) graph.markCycle();
+    }
+
+    /* Predecessors are only kept when the chains themselves are wanted */
+    vector<int> predecessors;
+    if (chains > 0) predecessors.assign(graph.getNumberOfNodes(), 0);
+
+    if (solver == "level") {
+
+        /* Finds minimum interventions and biggest sequence processing each level in parallel */
+        vector<levelStatsStruct> levels;
+        vector<levelStatsStruct>* stats = reportLevels ? &levels : nullptr;
+        timer.start("solve");
+        dominoResultStruct result = solveWithLevels(&graph, workers, stats);
+        timer.stop();
+        cout << result.interventions << " " << result.sequence << endl;
+
+        /* Parallelism is how many workers' worth of edges were relaxed while the busiest one ran */
+        if (reportLevels) {
+            cerr << "level nodes edges parallelism" << endl;
+            for (size_t level = 0; level < levels.size(); level++) {
+                const levelStatsStruct& stats = levels[level];
+                double parallelism = stats.busiest ? (double) stats.edges / stats.busiest : 1.0;
+                cerr << level + 1 << " " << stats.nodes << " " << stats.edges << " " << parallelism
+                     << endl;
+            }
+        }
+
+    } else if (solver == "scc") {
+
+        /* Finds minimum interventions and biggest sequence on the graph of components */
+        timer.start("solve");
+        dominoResultStruct result = solveWithComponents(&graph);
+        timer.stop();
+        cout << result.interventions << " " << result.sequence << endl;
+
+    } else if (solver == "kahn") {
+
+        /* Finds minimum interventions and biggest sequence in a single sweep over the edges */
+        timer.start("solve");
+        dominoResultStruct result = solveWithKahn(&graph, predecessors.empty() ? nullptr
+                                                                                : &predecessors);
+        timer.stop();
+        cout << result.interventions << " " << result.sequence << endl;
+        if (chains > 0) printChains(&graph, predecessors, chains, original);
+
+    } else {
+
+        /* Performs a DFS and returns an array with all the vertices inversely sorted by finish time,
+         * or lets several workers build any other topological order. Pieces renumbered without
+         * cycles are already in topological order */
+        timer.start("order");
+        topologicalOrder topological(graph.getAllocator());
+        if (!original.empty() && !graph.hasCycle() && order == "dfs") {
+            topological.resize(graph.getNumberOfNodes());
+            iota(topological.begin(), topological.end(), 1);
+        } else {
+            topological = order == "stealing" ? parallelTopologicalOrder(&graph, workers)
+                                              : graph.dfs();
+        }
+
+        /* Finds minimum interventions and biggest sequence. Prints them on the screen */
+        timer.start("path");
+        solveDominoPiecesProblem(&graph, &topological, predecessors.empty() ? nullptr
+                                                                            : &predecessors);
+        timer.stop();
+        if (chains > 0) printChains(&graph, predecessors, chains, original);
+
+    }
 
-    /* Finds minimum interventions and biggest sequence. Prints them on the screen */
-    solveDominoPiecesProblem(&graph, &topological);
+    if (reportStats) printStats(cerr, timer, graph.getPeakDfsAuxSize());
 
     exit(EXIT_SUCCESS);
 
@@ -0,0 +1,128 @@
+#include "orderSolver.h"
+#include "relaxKernel.h"
+#include "stats.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Counts number os times we have to make a piece fall to traverse all the pieces (is just
+ *        the amount of node with in degree 0). Also finds longest path in our graph by relaxing
+ *        every node's children following a topological order, which is emptied on the way. Node
+ *        distances are left in the graph. Unless predecessors are wanted, children are relaxed by
+ *        the vector kernel this CPU supports.
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @param topological stack with nodes in topological order
+ * @param predecessors if not null, receives every node's parent in its longest sequence (0 for
+ *        nodes starting one). Must hold one entry per node
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct solveWithOrder(Graph* graph, topologicalOrder* topological,
+                                  vector<int>* predecessors) {
+
+    /* Hold the amount of times we have to make a piece fall to traverse all the pieces */
+    int interventions = 0, sequence = 0;
+
+    /* The kernel works straight on the distances, so it needs them in one array */
+    int* distances = predecessors ? nullptr : graph->getNodeDistances();
+    relaxKernel relax = getRelaxKernel();
+
+    /* Counts number of nodes with in degree 0 (interventions) and sets their distance as 1. This
+     * will be used later on when we try to find the longest path */
+    for (int node = 1; node <= graph->getNumberOfNodes(); node++) {
+        if (graph->getNodeInDegree(node) == 0) {
+            interventions++;
+            graph->setNodeDistance(node, 1);
+        }
+    }
+
+    /* We traverse all the nodes in our topological stack and traverse them one by one. While doing
+     * this, we traverse their children and change their distance. This will count the number of
+     * edges between them and their parents */
+    while ( ! topological->empty()) {
+
+        /* Gets node from stack */
+        int node = topological->front(); topological->pop_front();
+
+        /* Traverses children sets their distance */
+        int parentDist = graph->getNodeDistance(node);
+
+        if (parentDist != NEGATIVE_INFINITY) {
+
+            /* Children are walked through a view, so nothing is copied or allocated here */
+            adjacencyViewStruct children = graph->getAdjacentNodes(node);
+            STATS_ADD(edgesRelaxed, children.size());
+
+            /* A child not growing already had a distance at least as long, which some earlier
+             * relaxation set, so the sequence can be raised without looking at each child */
+            if (distances != nullptr) {
+                size_t updated = relax(distances, children.begin(), children.size(), parentDist + 1);
+                STATS_ADD(distanceUpdates, updated);
+                if (!children.empty()) sequence = max(sequence, parentDist + 1);
+                continue;
+            }
+
+            for (int child : children) {
+
+                if (graph->getNodeDistance(child) < parentDist + 1) {
+
+                    graph->setNodeDistance(child, parentDist + 1);
+                    STATS_ADD(distanceUpdates, 1);
+                    if (predecessors) (*predecessors)[child-1] = node;
+
+                    /* Finds and holds longest distance. Is done here as to avoid doing another loop
+                     * to find the highest distance */
+                    if (parentDist + 1 > sequence) sequence = parentDist + 1;
+
+                }
+
+            }
+
+        }
+
+    }
+
+    dominoResultStruct result = {interventions, sequence};
+    return result;
+
+}
+
+
+/**
+ * @brief Rebuilds the longest sequences ending at the pieces that topple nothing else, largest
+ *        distances first, following the predecessors recorded while solving. Sequences may share
+ *        their first pieces, but none is a prefix of another.
+ *
+ * @param graph solved graph, with every node's distance
+ * @param predecessors every node's parent in its longest sequence, as recorded by the solvers
+ * @param count number of sequences wanted
+ * @return up to count sequences, longest first, each from the piece pushed to the last one falling
+ */
+vector<vector<int>> getLongestChains(const Graph* graph, const vector<int>& predecessors,
+                                     int count) {
+
+    /* Only sequences ending at a piece toppling nothing are kept, so none is part of another.
+     * The ends of the longest ones are sorted, ties going to the smallest node */
+    vector<int> ends;
+    for (int node = 1; node <= graph->getNumberOfNodes(); node++)
+        if (graph->getAdjacentNodes(node).empty()) ends.push_back(node);
+    count = max(0, min(count, (int) ends.size()));
+    auto longer = [graph](int first, int second) {
+        int firstDist = graph->getNodeDistance(first), secondDist = graph->getNodeDistance(second);
+        return firstDist != secondDist ? firstDist > secondDist : first < second;
+    };
+    partial_sort(ends.begin(), ends.begin() + count, ends.end(), longer);
+
+    /* Every sequence is walked backwards from its end and then turned around */
+    vector<vector<int>> chains(count);
+    for (int i = 0; i < count; i++) {
+        for (int node = ends[i]; node != 0; node = predecessors[node-1])
+            chains[i].push_back(node);
+        reverse(chains[i].begin(), chains[i].end());
+    }
+
+    return chains;
+
+}
@@ -0,0 +1,40 @@
+#ifndef ORDER_SOLVER_H
+#define ORDER_SOLVER_H
+
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Counts number os times we have to make a piece fall to traverse all the pieces (is just
+ *        the amount of node with in degree 0). Also finds longest path in our graph by relaxing
+ *        every node's children following a topological order, which is emptied on the way. Node
+ *        distances are left in the graph.
+ *
+ * @param graph graph representing domino problem which will be traversed
+ * @param topological stack with nodes in topological order
+ * @param predecessors if not null, receives every node's parent in its longest sequence (0 for
+ *        nodes starting one). Must hold one entry per node
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct solveWithOrder(Graph* graph, topologicalOrder* topological,
+                                  vector<int>* predecessors = nullptr);
+
+
+/**
+ * @brief Rebuilds the longest sequences ending at the pieces that topple nothing else, largest
+ *        distances first, following the predecessors recorded while solving. Sequences may share
+ *        their first pieces, but none is a prefix of another.
+ *
+ * @param graph solved graph, with every node's distance
+ * @param predecessors every node's parent in its longest sequence, as recorded by the solvers
+ * @param count number of sequences wanted
+ * @return up to count sequences, longest first, each from the piece pushed to the last one falling
+ */
+vector<vector<int>> getLongestChains(const Graph* graph, const vector<int>& predecessors,
+                                     int count);
+
+
+#endif // ORDER_SOLVER_H
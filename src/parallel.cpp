@@ -0,0 +1,65 @@
+#include <thread>
+#include <vector>
+#include "parallel.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Gets how many workers to use when the caller did not ask for a specific amount.
+ *
+ * @return number of hardware threads available, at least 1
+ */
+int getDefaultWorkers() {
+    unsigned threads = thread::hardware_concurrency();
+    return threads == 0 ? 1 : (int) threads;
+}
+
+
+/**
+ * @brief Runs a task once per worker, each on its own thread (worker 0 runs on the calling thread),
+ *        and waits for all of them to finish.
+ *
+ * @param workers number of workers
+ * @param task task to run. Receives the worker's index in [0, workers)
+ */
+void runWorkers(int workers, const function<void(int)>& task) {
+
+    vector<thread> pool;
+    for (int worker = 1; worker < workers; worker++) pool.emplace_back(task, worker);
+
+    task(0);
+
+    for (auto& thread : pool) thread.join();
+
+}
+
+
+/**
+ * @brief Barrier constructor.
+ *
+ * @param workers number of workers taking part
+ */
+Barrier::Barrier(int workers) : _workers(workers), _waiting(0), _round(0) {}
+
+
+/**
+ * @brief Blocks until every worker has called it.
+ */
+void Barrier::wait() {
+
+    unique_lock<mutex> lock(this->_mutex);
+    unsigned long round = this->_round;
+
+    /* The last worker to arrive starts a new round and releases everybody else */
+    if (++this->_waiting == this->_workers) {
+        this->_waiting = 0;
+        this->_round++;
+        this->_released.notify_all();
+        return;
+    }
+
+    this->_released.wait(lock, [&] { return this->_round != round; });
+
+}
@@ -0,0 +1,81 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+
+using namespace std;
+
+
+/**
+ * @brief Gets how many workers to use when the caller did not ask for a specific amount.
+ *
+ * @return number of hardware threads available, at least 1
+ */
+int getDefaultWorkers();
+
+
+/**
+ * @brief Runs a task once per worker, each on its own thread (worker 0 runs on the calling thread),
+ *        and waits for all of them to finish.
+ *
+ * @param workers number of workers
+ * @param task task to run. Receives the worker's index in [0, workers)
+ */
+void runWorkers(int workers, const function<void(int)>& task);
+
+
+
+/**
+ * @brief Makes a fixed group of workers wait for each other before moving on. Can be reused as many
+ *        times as needed (e.g. once per level of a level synchronous traversal).
+ */
+class Barrier {
+
+    private:
+
+        /**
+         * @brief Protects every other member.
+         */
+        mutex _mutex;
+
+        /**
+         * @brief Wakes up the workers waiting on the current round.
+         */
+        condition_variable _released;
+
+        /**
+         * @brief Holds number of workers taking part.
+         */
+        int _workers;
+
+        /**
+         * @brief Holds number of workers already waiting on the current round.
+         */
+        int _waiting;
+
+        /**
+         * @brief Holds how many rounds were completed. Tells a new round apart from the last one.
+         */
+        unsigned long _round;
+
+    public:
+
+        /**
+         * @brief Barrier constructor.
+         *
+         * @param workers number of workers taking part
+         */
+        explicit Barrier(int workers);
+
+        /**
+         * @brief Blocks until every worker has called it.
+         */
+        void wait();
+
+};
+
+
+#endif // PARALLEL_H
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <thread>
+#include "parallel.h"
+#include "parallelTopological.h"
+#include "workStealingDeque.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Sorts the graph topologically with several workers, as a parallel alternative to
+ *        Graph::dfs(). Every worker owns a work stealing deque and keeps going down the children it
+ *        released (depth first), while idle workers steal the oldest pending nodes of the others. A
+ *        node is claimed once its last parent was placed in the order, so every parent always comes
+ *        before its children. Every placed node is left black, as dfs() does. Nodes on a cycle are
+ *        never claimed, so the graph is marked as cyclic when some are left out of the order.
+ *
+ * @param graph graph to be sorted
+ * @param workers number of workers, 0 to use every hardware thread
+ * @return deque with nodes in topological order
+ */
+topologicalOrder parallelTopologicalOrder(Graph* graph, int workers) {
+
+    int nodes = graph->getNumberOfNodes();
+    if (workers <= 0) workers = getDefaultWorkers();
+
+    /* Holds how many parents of each node were not placed in the order yet. The worker taking it
+     * to 0 is the only one to ever claim that node */
+    unique_ptr<atomic<int>[]> remaining(new atomic<int>[nodes]);
+
+    /* Holds the nodes in topological order and the next free position */
+    arenaVector<int> order(nodes, 0, graph->getAllocator());
+    atomic<int> placed(0);
+
+    /* Holds how many nodes were released but not fully processed yet. Work is over at 0 */
+    atomic<int> outstanding(0);
+
+    /* Nodes with in degree 0 are spread over every worker's deque before any of them starts */
+    vector<unique_ptr<WorkStealingDeque>> deques;
+    for (int worker = 0; worker < workers; worker++) deques.emplace_back(new WorkStealingDeque());
+    int sources = 0;
+    for (int node = 1; node <= nodes; node++) {
+        int inDegree = graph->getNodeInDegree(node);
+        remaining[node-1].store(inDegree, memory_order_relaxed);
+        if (inDegree == 0) deques[sources++ % workers]->push(node);
+    }
+    outstanding.store(sources);
+
+    runWorkers(workers, [&](int worker) {
+
+        WorkStealingDeque& own = *deques[worker];
+        int node = 0, victim = worker;
+
+        while (outstanding.load(memory_order_acquire) > 0) {
+
+            /* Takes the newest local node or, when there is none, steals from the others */
+            if (!own.pop(node)) {
+                victim = (victim + 1) % workers;
+                if (victim == worker || !deques[victim]->steal(node)) {
+                    this_thread::yield();
+                    continue;
+                }
+            }
+
+            /* The node is placed before its children are released, so it always precedes them */
+            order[placed.fetch_add(1, memory_order_relaxed)] = node;
+
+            for (int child : graph->getAdjacentNodes(node)) {
+                if (remaining[child-1].fetch_sub(1, memory_order_acq_rel) == 1) {
+                    outstanding.fetch_add(1, memory_order_relaxed);
+                    own.push(child);
+                }
+            }
+
+            outstanding.fetch_sub(1, memory_order_release);
+
+        }
+
+    });
+
+    /* Colors are packed several to a word, so they are only written once the workers are done */
+    for (int i = 0; i < placed.load(); i++) graph->setNodeColor(order[i], Color::black);
+    if (placed.load() < nodes) graph->markCycle();
+
+    return topologicalOrder(order.begin(), order.begin() + placed.load(), graph->getAllocator());
+
+}
@@ -0,0 +1,25 @@
+#ifndef PARALLEL_TOPOLOGICAL_H
+#define PARALLEL_TOPOLOGICAL_H
+
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Sorts the graph topologically with several workers, as a parallel alternative to
+ *        Graph::dfs(). Every worker owns a work stealing deque and keeps going down the children it
+ *        released (depth first), while idle workers steal the oldest pending nodes of the others. A
+ *        node is claimed once its last parent was placed in the order, so every parent always comes
+ *        before its children. Every placed node is left black, as dfs() does. Nodes on a cycle are
+ *        never claimed, so the graph is marked as cyclic when some are left out of the order.
+ *
+ * @param graph graph to be sorted
+ * @param workers number of workers, 0 to use every hardware thread
+ * @return deque with nodes in topological order
+ */
+topologicalOrder parallelTopologicalOrder(Graph* graph, int workers);
+
+
+#endif // PARALLEL_TOPOLOGICAL_H
@@ -0,0 +1,254 @@
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "orderSolver.h"
+#include "queryServer.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief GraphQueries constructor. Solves the graph and precomputes every array queries use.
+ *
+ * @param graph graph to be asked about. Must have its adjacency built and no cycles
+ * @param options how the reachability index trades memory for query time
+ */
+GraphQueries::GraphQueries(Graph* graph, const reachabilityOptionsStruct& options)
+    : _graph(graph), _down(graph->getNumberOfNodes(), 1), _reachedBy(graph->getNumberOfNodes(), 0),
+      _traversal(0) {
+
+    /* Keeps the topological order, since solving it empties it, and leaves every distance */
+    topologicalOrder topological = graph->dfs();
+    if (graph->hasCycle()) {
+        cerr << "queries need pieces placed without cycles" << endl;
+        exit(EXIT_FAILURE);
+    }
+    this->_order.assign(topological.begin(), topological.end());
+    this->_result = solveWithOrder(graph, &topological);
+
+    /* The longest sequence starting at a node follows its best child, so children go first */
+    for (auto node = this->_order.rbegin(); node != this->_order.rend(); node++)
+        for (int child : graph->getAdjacentNodes(*node))
+            this->_down[*node-1] = max(this->_down[*node-1], this->_down[child-1] + 1);
+
+    graph->buildParentAdjacency();
+    this->_index.reset(new ReachabilityIndex(graph, this->_order, options));
+
+}
+
+
+/**
+ * @brief Get the Result object.
+ *
+ * @return number of interventions and longest sequence
+ */
+dominoResultStruct GraphQueries::getResult() const { return this->_result; }
+
+
+/**
+ * @brief Get the Longest Chain Through object.
+ *
+ * @param node node value
+ * @return number of pieces in the longest sequence going through this piece
+ */
+int GraphQueries::getLongestChainThrough(int node) const {
+
+    /* Longest sequence ending at the piece followed by the longest one leaving it, which share it */
+    return this->_graph->getNodeDistance(node) + this->_down[node-1] - 1;
+
+}
+
+
+/**
+ * @brief Get the Pushers object.
+ *
+ * @param node node value
+ * @return every piece with no parents (one that has to be pushed) whose fall reaches this piece, in
+ *         increasing order. Pushing any of them topples it
+ */
+vector<int> GraphQueries::getPushers(int node) {
+
+    vector<int> pushers;
+    this->_traversal++;
+    this->_frontier.assign(1, node);
+    this->_reachedBy[node-1] = this->_traversal;
+
+    /* Walks every ancestor, keeping the ones nothing leads to */
+    while (!this->_frontier.empty()) {
+        int current = this->_frontier.back();
+        this->_frontier.pop_back();
+        adjacencyViewStruct parents = this->_graph->getParentNodes(current);
+        if (parents.empty()) pushers.push_back(current);
+        for (int parent : parents) {
+            if (this->_reachedBy[parent-1] == this->_traversal) continue;
+            this->_reachedBy[parent-1] = this->_traversal;
+            this->_frontier.push_back(parent);
+        }
+    }
+
+    sort(pushers.begin(), pushers.end());
+    return pushers;
+
+}
+
+
+/**
+ * @brief Get the Reach Count object.
+ *
+ * @param node node value
+ * @return number of pieces that fall when this piece is pushed, itself included
+ */
+size_t GraphQueries::getReachCount(int node) { return this->_index->getReachCount(node); }
+
+
+/**
+ * @brief Tells whether pushing a piece topples another one.
+ *
+ * @param from node pushed
+ * @param to node that may topple
+ * @return true if to falls when from is pushed
+ */
+bool GraphQueries::topples(int from, int to) { return this->_index->reaches(from, to); }
+
+
+/**
+ * @brief Get the Index object.
+ *
+ * @return reachability index answering reach and topples queries
+ */
+const ReachabilityIndex* GraphQueries::getIndex() const { return this->_index.get(); }
+
+
+/**
+ * @brief Answers one query line: "chain node", "pushers node", "reach node",
+ *        "topples node node" or "answer".
+ *
+ * @param line query
+ * @return answer, or a line starting with "error" if the query is malformed
+ */
+string GraphQueries::answer(const string& line) {
+
+    istringstream tokens(line);
+    string query;
+    tokens >> query;
+
+    if (query == "answer")
+        return to_string(this->_result.interventions) + " " + to_string(this->_result.sequence);
+    if (query != "chain" && query != "pushers" && query != "reach" && query != "topples")
+        return "error unknown query, expected chain, pushers, reach, topples or answer";
+
+    int node = 0, other = 0, nodes = this->_graph->getNumberOfNodes();
+    if (!(tokens >> node) || node < 1 || node > nodes)
+        return "error expected a node in [1, " + to_string(nodes) + "]";
+    if (query == "topples" && (!(tokens >> other) || other < 1 || other > nodes))
+        return "error expected two nodes in [1, " + to_string(nodes) + "]";
+
+    if (query == "chain") return to_string(this->getLongestChainThrough(node));
+    if (query == "reach") return to_string(this->getReachCount(node));
+    if (query == "topples") return this->topples(node, other) ? "yes" : "no";
+
+    /* Number of pushers followed by each of them */
+    vector<int> pushers = this->getPushers(node);
+    string result = to_string(pushers.size());
+    for (int pusher : pushers) result += " " + to_string(pusher);
+    return result;
+
+}
+
+
+/**
+ * @brief Answers every query line read from a stream until it ends or a "quit" line arrives.
+ *
+ * @param queries precomputed graph queries
+ * @param in where queries are read from
+ * @param out where answers are written, one line per query
+ */
+void serveQueries(GraphQueries* queries, istream& in, ostream& out) {
+
+    /* Answers are flushed right away, since the other end is usually waiting for them */
+    for (string line; getline(in, line) && line != "quit"; ) {
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+        out << queries->answer(line) << endl;
+    }
+
+}
+
+
+/**
+ * @brief Writes a whole buffer to a socket, ignoring a client that went away.
+ *
+ * @param fd socket
+ * @param data bytes to be written
+ * @return false if the client is gone
+ */
+static bool sendAll(int fd, const string& data) {
+
+    for (size_t sent = 0; sent < data.size(); ) {
+        ssize_t written = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) return false;
+        sent += written;
+    }
+
+    return true;
+
+}
+
+
+/**
+ * @brief Listens on a Unix socket and answers the query lines of every client that connects, one
+ *        client after the other. Each client is served until it disconnects or sends "quit".
+ *
+ * @param queries precomputed graph queries
+ * @param path path of the socket. Any file already there is replaced
+ */
+void serveSocket(GraphQueries* queries, const string& path) {
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << path << ": socket path is too long" << endl;
+        exit(EXIT_FAILURE);
+    }
+    strcpy(address.sun_path, path.c_str());
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (server < 0 || bind(server, (struct sockaddr*) &address, sizeof(address)) != 0 ||
+        listen(server, 16) != 0) {
+        cerr << path << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    char block[1 << 16];
+    while (true) {
+
+        int client = accept(server, nullptr, nullptr);
+        if (client < 0) continue;
+
+        /* Queries may arrive split across reads, so only whole lines are answered */
+        string pending;
+        bool open = true;
+        ssize_t received;
+        while (open && (received = read(client, block, sizeof(block))) > 0) {
+            pending.append(block, received);
+            size_t start = 0, end;
+            string answers;
+            while (open && (end = pending.find('\n', start)) != string::npos) {
+                string line = pending.substr(start, end - start);
+                start = end + 1;
+                if (line == "quit" || line == "quit\r") open = false;
+                else if (line.find_first_not_of(" \t\r") != string::npos)
+                    answers += queries->answer(line) + "\n";
+            }
+            pending.erase(0, start);
+            if (!sendAll(client, answers)) open = false;
+        }
+
+        close(client);
+
+    }
+
+}
@@ -0,0 +1,155 @@
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include "graph.h"
+#include "reachabilityIndex.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Answers questions about a solved graph. Everything a query needs is computed once when it
+ *        is built: the topological order, every node's distance (longest sequence ending at it),
+ *        the longest sequence starting at every node, every node's parents and a reachability
+ *        index. Queries then only read those, apart from the traversals finding pushers.
+ */
+class GraphQueries {
+
+    private:
+
+        /**
+         * @brief Holds the graph being asked about.
+         */
+        Graph* _graph;
+
+        /**
+         * @brief Holds the answer to the domino problem.
+         */
+        dominoResultStruct _result;
+
+        /**
+         * @brief Holds every node in topological order.
+         */
+        vector<int> _order;
+
+        /**
+         * @brief Holds the number of pieces in the longest sequence starting at each node.
+         */
+        vector<int> _down;
+
+        /**
+         * @brief Holds which pieces every piece topples.
+         */
+        unique_ptr<ReachabilityIndex> _index;
+
+        /**
+         * @brief Holds, for every node, the last query that reached it. Tells reached nodes apart
+         *        without clearing anything between queries.
+         */
+        vector<unsigned> _reachedBy;
+
+        /**
+         * @brief Holds the number of the current traversal.
+         */
+        unsigned _traversal;
+
+        /**
+         * @brief Holds the nodes still to be expanded by the current traversal.
+         */
+        vector<int> _frontier;
+
+    public:
+
+        /**
+         * @brief GraphQueries constructor. Solves the graph and precomputes every array queries use.
+         *
+         * @param graph graph to be asked about. Must have its adjacency built and no cycles
+         * @param options how the reachability index trades memory for query time
+         */
+        GraphQueries(Graph* graph, const reachabilityOptionsStruct& options);
+
+        /**
+         * @brief Get the Result object.
+         *
+         * @return number of interventions and longest sequence
+         */
+        dominoResultStruct getResult() const;
+
+        /**
+         * @brief Get the Longest Chain Through object.
+         *
+         * @param node node value
+         * @return number of pieces in the longest sequence going through this piece
+         */
+        int getLongestChainThrough(int node) const;
+
+        /**
+         * @brief Get the Pushers object.
+         *
+         * @param node node value
+         * @return every piece with no parents (one that has to be pushed) whose fall reaches this
+         *         piece, in increasing order. Pushing any of them topples it
+         */
+        vector<int> getPushers(int node);
+
+        /**
+         * @brief Get the Reach Count object.
+         *
+         * @param node node value
+         * @return number of pieces that fall when this piece is pushed, itself included
+         */
+        size_t getReachCount(int node);
+
+        /**
+         * @brief Tells whether pushing a piece topples another one.
+         *
+         * @param from node pushed
+         * @param to node that may topple
+         * @return true if to falls when from is pushed
+         */
+        bool topples(int from, int to);
+
+        /**
+         * @brief Get the Index object.
+         *
+         * @return reachability index answering reach and topples queries
+         */
+        const ReachabilityIndex* getIndex() const;
+
+        /**
+         * @brief Answers one query line: "chain node", "pushers node", "reach node",
+         *        "topples node node" or "answer".
+         *
+         * @param line query
+         * @return answer, or a line starting with "error" if the query is malformed
+         */
+        string answer(const string& line);
+
+};
+
+
+/**
+ * @brief Answers every query line read from a stream until it ends or a "quit" line arrives.
+ *
+ * @param queries precomputed graph queries
+ * @param in where queries are read from
+ * @param out where answers are written, one line per query
+ */
+void serveQueries(GraphQueries* queries, istream& in, ostream& out);
+
+
+/**
+ * @brief Listens on a Unix socket and answers the query lines of every client that connects, one
+ *        client after the other. Each client is served until it disconnects or sends "quit".
+ *
+ * @param queries precomputed graph queries
+ * @param path path of the socket. Any file already there is replaced
+ */
+void serveSocket(GraphQueries* queries, const string& path);
+
+
+#endif // QUERY_SERVER_H
@@ -4,102 +4,569 @@
  *  - prob p of creating the edge (u,v)
  *
  * Pedro T. Monteiro - Pedro.Tiago.Monteiro@tecnico.ulisboa.pt
+ *
+ * Edges are found by geometric skipping (O(V+E) instead of
+ * O(V^2)) and every vertex draws from its own xoshiro256**
+ * stream seeded from (seed, vertex), so the output only depends
+ * on V, p and the seed, never on the number of threads.
+ *
+ * Besides random DAGs it builds structured families (chains,
+ * fan-outs, layered grids and power-law out degrees) with an
+ * exact number of vertices, edges, layers (depth) and width.
  *************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
-#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "binaryGraph.h"
 
 using namespace std;
 
+// Number of edges each output chunk roughly holds
+#define CHUNK_EDGES (1 << 18)
+
 // Graph
 int _V;
-int _E = 0;
-list<int>* _g;
+uint64_t _E = 0;
+vector<int> _degree;  // out degree of each vertex position
+
+double _prob;
+uint64_t _seed;
+int _threads;
+bool _binary = false;
+vector<int> _v2ID;    // map vertex position to ID
+vector<int> _ID2v;    // map ID to vertex position
 
-float _prob;
-int* _v2ID;  // map vertex position to ID
+// Structured families
+string _family = "random";
+int _depth = 0;       // number of layers (0: family default)
+int _width = 0;       // vertices in the largest layer (0: family default)
+int64_t _edges = -1;  // exact number of edges (-1: family default)
+double _alpha = 1;    // power-law exponent
+vector<int> _layerStart;    // position of each layer's first vertex, plus V
+vector<uint64_t> _offsets;  // edges of position u: _targets[_offsets[u], _offsets[u+1])
+vector<int> _targets;
 
 //-------------------------------------------------------------------
 
 void printUsage() {
-	cout << "Usage: randomDAG #V #p seed" << endl;
+	cout << "Usage: randomDAG [-t #threads] [-b] #V #p seed" << endl;
+	cout << "       randomDAG [-t #threads] [-b] -f family [-d #depth] [-w #width] [-e #E]" << endl;
+	cout << "                 [-a alpha] #V seed" << endl;
 	cout << "\t#V: number of vertices" << endl;
 	cout << "\t#p: prob \\in [0,1] to create edge (u,v)" << endl;
 	cout << "\tseed: random seed number (optional)" << endl;
+	cout << "\t-t: number of threads (default: every hardware thread)" << endl;
+	cout << "\t-b: write a binary graph instead of an edge list" << endl;
+	cout << "\t-f: chain (#width parallel chains, default 1)," << endl;
+	cout << "\t    fanout (tree of #depth layers growing geometrically up to #width, default 2" << endl;
+	cout << "\t    or as few as fit with #width)," << endl;
+	cout << "\t    grid (#width x #depth lattice, default sqrt(#V) wide)," << endl;
+	cout << "\t    powerlaw (layers with out degrees following a power law of exponent alpha)" << endl;
+	cout << "\t-d: number of layers, i.e. vertices in the longest path" << endl;
+	cout << "\t-w: number of vertices in the largest layer" << endl;
+	cout << "\t-e: exact number of edges (default: chain and fanout only keep the edge linking" << endl;
+	cout << "\t    each vertex to the previous layer, grid adds diagonals, powerlaw 4 #V)" << endl;
+	cout << "\t-a: power-law exponent (default 1)" << endl;
 	exit(0);
 }
 
 void parseArgs(int argc, char **argv) {
-	int seed = 0;
+	vector<char*> args;
+
+	_threads = max(1u, thread::hardware_concurrency());
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-b") == 0) {
+			_binary = true;
+		} else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%d", &_threads);
+			if (_threads < 1) {
+				cout << "ERROR: # threads must be >= 1" << endl;
+				printUsage();
+			}
+		} else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+			_family = argv[++i];
+			if (_family != "random" && _family != "chain" && _family != "fanout" &&
+			    _family != "grid" && _family != "powerlaw") {
+				cout << "ERROR: unknown family " << _family << endl;
+				printUsage();
+			}
+		} else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%d", &_depth);
+		} else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%d", &_width);
+		} else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%lld", (long long*) &_edges);
+		} else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%lf", &_alpha);
+		} else {
+			args.push_back(argv[i]);
+		}
+	}
 
-	if (argc < 3) printUsage();
+	// structured families take no probability
+	bool random = _family == "random";
+	if (args.size() < (random ? 2u : 1u)) printUsage();
 
-	sscanf(argv[1], "%d", &_V);
+	sscanf(args[0], "%d", &_V);
 	if (_V < 1) {
 		cout << "ERROR: # vertices must be > 1" << endl;
 		printUsage();
 	}
 
-	sscanf(argv[2], "%f", &_prob);
-	if (_prob < 0 || _prob > 1) {
-		cout << "ERROR: Prob to create edge (u,v) between [0,1]" << endl;
+	if (random) {
+		sscanf(args[1], "%lf", &_prob);
+		if (_prob < 0 || _prob > 1) {
+			cout << "ERROR: Prob to create edge (u,v) between [0,1]" << endl;
+			printUsage();
+		}
+	}
+
+	if (_depth < 0 || _depth > _V || _width < 0 || _width > _V) {
+		cout << "ERROR: # depth and # width must be in [1, #V]" << endl;
 		printUsage();
 	}
 
-	if (argc > 3) {
+	size_t seedArg = random ? 2 : 1;
+	if (args.size() > seedArg) {
 		// Init rand seed
-		sscanf(argv[3], "%d", &seed);
-		srand(seed);
+		sscanf(args[seedArg], "%llu", (unsigned long long*) &_seed);
 	} else {
-		srand((unsigned int)time(NULL));
+		_seed = (uint64_t) time(NULL);
 	}
 }
 
+//-------------------------------------------------------------------
 
-int randomValue(int max) {
-	return rand() % max; // [0, max - 1]
+// splitmix64 step, used to expand a seed into a full generator state
+uint64_t splitmix(uint64_t& x) {
+	uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
 }
 
-void addEdge(int u, int v) {
-	if (((float) rand() / RAND_MAX) <= _prob) {
-		_g[u].push_back(v);
-		_E++;
+// xoshiro256** generator, one per stream
+struct Random {
+	uint64_t s[4];
+
+	Random(uint64_t seed, uint64_t stream) {
+		uint64_t x = seed ^ splitmix(stream);
+		for (int i = 0; i < 4; i++) s[i] = splitmix(x);
 	}
+
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	uint64_t next() {
+		uint64_t result = rotl(s[1] * 5, 7) * 9;
+		uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 45);
+		return result;
+	}
+
+	// uniform in (0, 1]
+	double uniform() { return ((next() >> 11) + 1) * (1.0 / 9007199254740992.0); }
+
+	// uniform in [0, max - 1]
+	int value(int max) { return (int) (((next() >> 32) * (uint64_t) max) >> 32); }
+};
+
+// Calls emit(v) for every edge (u,v), v > u, by jumping straight from one edge to
+// the next: the number of pairs skipped follows a geometric distribution
+template <class Emit>
+void generateEdges(int u, Emit emit) {
+	if (_prob <= 0) return;
+	if (_prob >= 1) {
+		for (int v = u + 1; v < _V; v++) emit(v);
+		return;
+	}
+
+	Random random(_seed, (uint64_t) u + 1);
+	double logq = log(1 - _prob);
+	int64_t v = u;
+	while (true) {
+		v += 1 + (int64_t) floor(log(random.uniform()) / logq);
+		if (v >= _V) break;
+		emit((int) v);
+	}
+}
+
+// Runs task(t) on _threads threads and waits for all of them
+template <class Task>
+void runThreads(Task task) {
+	vector<thread> threads;
+	for (int t = 1; t < _threads; t++) threads.emplace_back(task, t);
+	task(0);
+	for (thread& t : threads) t.join();
+}
+
+//-------------------------------------------------------------------
+// Structured families: the V vertices are split into `depth` layers,
+// the largest one holding `width` of them. Every vertex past the first
+// layer gets one parent in the previous layer (the spine), so the
+// longest path has exactly `depth` vertices, and every other edge also
+// links a layer to the next one until there are exactly E edges.
+
+int layerSize(int l) { return _layerStart[l + 1] - _layerStart[l]; }
+
+int layerOf(int u) {
+	return upper_bound(_layerStart.begin(), _layerStart.end(), u) - _layerStart.begin() - 1;
+}
+
+// Spine parent (inside layer l) of the k-th vertex of layer l + 1
+int spineParent(int l, int k) { return (int) ((int64_t) k * layerSize(l) / layerSize(l + 1)); }
+
+void layerError(const char* message) {
+	cout << "ERROR: " << message << endl;
+	printUsage();
+}
+
+// Splits n vertices over k layers as evenly as possible
+void splitEvenly(vector<int>& sizes, int n, int k) {
+	for (int l = 0; l < k; l++) sizes.push_back(n / k + (l < n % k));
+}
+
+// Splits n vertices over k layers growing geometrically, none larger than cap (k <= n <= k cap),
+// so the last one is the largest
+void splitGeometrically(vector<int>& sizes, int n, int k, int cap) {
+	// ratio r such that min(cap, 1) + min(cap, r) + ... + min(cap, r^(k-1)) = n
+	double low = 1, high = n;
+	for (int i = 0; i < 100; i++) {
+		double r = (low + high) / 2, sum = 0, term = 1;
+		for (int l = 0; l < k && sum <= n; l++, term *= r) sum += min((double) cap, term);
+		(sum > n ? high : low) = r;
+	}
+	int total = 0, first = sizes.size();
+	for (int l = 0; l < k; l++) {
+		sizes.push_back((int) min((double) cap, max(1.0, (double) llround(pow(low, l)))));
+		total += sizes.back();
+	}
+	// rounding leftovers go to the last layers while they stay within [1, cap]
+	for (int l = k - 1; l >= 0 && total != n; l--) {
+		int& size = sizes[first + l];
+		int change = total < n ? min(n - total, cap - size) : -min(total - n, size - 1);
+		size += change;
+		total += change;
+	}
+}
+
+void buildLayers() {
+	vector<int> sizes;
+
+	if (_family == "fanout") {
+		// without #depth, 2 layers, or as few as hold #V with none larger than #width
+		int depth = _depth ? _depth : !_width ? min(2, _V) :
+		            _V == _width ? 1 : max(2, (_V + _width - 1) / _width);
+		if (!_width) {
+			splitGeometrically(sizes, _V, depth, _V);
+		} else if (depth == 1 ? _V != _width : _V - _width < depth - 1 ||
+		           _V - _width > (int64_t) (depth - 1) * _width) {
+			layerError("#V does not fit in #depth layers growing up to a last layer of #width");
+		} else {
+			// the last layer is the widest, the others grow towards it
+			if (depth > 1) splitGeometrically(sizes, _V - _width, depth - 1, _width);
+			sizes.push_back(_width);
+		}
+	} else {
+		if (!_depth && !_width) _width = _family == "chain" ? 1 : (int) ceil(sqrt((double) _V));
+		if (_depth && _width) {
+			// first layer is the widest, the others share what is left
+			if (_depth == 1 ? _V != _width : _V - _width < _depth - 1 ||
+			    _V - _width > (int64_t) (_depth - 1) * _width)
+				layerError("#V does not fit in #depth layers of at most #width vertices");
+			sizes.push_back(_width);
+			splitEvenly(sizes, _V - _width, _depth - 1);
+		} else if (_width) {
+			for (int left = _V; left > 0; left -= _width) sizes.push_back(min(left, _width));
+		} else {
+			splitEvenly(sizes, _V, _depth);
+		}
+	}
+
+	_layerStart.assign(1, 0);
+	for (int size : sizes) _layerStart.push_back(_layerStart.back() + size);
+	_depth = sizes.size();
+	_width = *max_element(sizes.begin(), sizes.end());
+}
+
+// Edges are kept as (u << 32 | v) so that sorting groups them by parent
+uint64_t edgeKey(int u, int v) { return (uint64_t) u << 32 | (uint32_t) v; }
+
+void buildStructured() {
+	buildLayers();
+
+	vector<uint64_t> edges;
+	uint64_t capacity = 0;
+	vector<uint64_t> capacities(1, 0);  // running count of possible edges per layer
+	for (int l = 0; l + 1 < _depth; l++) {
+		for (int k = 0; k < layerSize(l + 1); k++)
+			edges.push_back(edgeKey(_layerStart[l] + spineParent(l, k), _layerStart[l + 1] + k));
+		capacity += (uint64_t) layerSize(l) * layerSize(l + 1);
+		capacities.push_back(capacity);
+	}
+
+	uint64_t spine = edges.size();
+	uint64_t target = _edges >= 0 ? (uint64_t) _edges : spine;
+	if (_edges < 0 && _family == "grid") target = spine + (_V - _layerStart[1] - (_depth - 1));
+	if (_edges < 0 && _family == "powerlaw") target = min(capacity, (uint64_t) 4 * _V);
+	if (target < spine || target > capacity) {
+		cout << "ERROR: #E must be in [" << spine << ", " << capacity << "] for these layers" << endl;
+		printUsage();
+	}
+
+	Random random(_seed, (uint64_t) _V + 1);
+
+	// grid: diagonals, linking each vertex to the neighbour of its spine parent
+	if (_family == "grid") {
+		for (int l = 0; l + 1 < _depth && edges.size() < target; l++)
+			for (int k = 0; k < layerSize(l + 1) && edges.size() < target; k++)
+				if (spineParent(l, k) > 0)
+					edges.push_back(edgeKey(_layerStart[l] + spineParent(l, k) - 1, _layerStart[l + 1] + k));
+	}
+
+	// powerlaw: parents are ranked in a random order and picked with weight 1 / rank^alpha
+	vector<double> weights;
+	vector<int> ranked;
+	if (_family == "powerlaw" && _depth > 1) {
+		int parents = _layerStart[_depth - 1];
+		ranked.resize(parents);
+		for (int u = 0; u < parents; u++) ranked[u] = u;
+		for (int u = parents - 1; u > 0; u--) swap(ranked[u], ranked[random.value(u + 1)]);
+		double sum = 0;
+		for (int r = 0; r < parents; r++) weights.push_back(sum += pow(r + 1, -_alpha));
+	}
+
+	// any other edge is drawn at random, dropping duplicates, until there are exactly E
+	bool skewed = !weights.empty();
+	uint64_t asked = 0, before = 0;
+	while (true) {
+		sort(edges.begin(), edges.end());
+		edges.erase(unique(edges.begin(), edges.end()), edges.end());
+		uint64_t missing = target - edges.size();
+		if (missing == 0) break;
+		// heavy parents may run out of children: once a round keeps under a tenth of its edges,
+		// the rest are drawn uniformly
+		if (asked > 0 && (edges.size() - before) * 10 < asked) skewed = false;
+		asked = missing;
+		before = edges.size();
+
+		// dense graphs would mostly draw duplicates, so the missing edges are picked among
+		// every absent one instead (edges are sorted, just as the walk below)
+		if (missing * 2 > capacity - edges.size()) {
+			vector<uint64_t> absent;
+			size_t present = 0;
+			for (int l = 0; l + 1 < _depth; l++) {
+				for (int u = _layerStart[l]; u < _layerStart[l + 1]; u++) {
+					for (int v = _layerStart[l + 1]; v < _layerStart[l + 2]; v++) {
+						uint64_t key = edgeKey(u, v);
+						while (present < edges.size() && edges[present] < key) present++;
+						if (present == edges.size() || edges[present] != key) absent.push_back(key);
+					}
+				}
+			}
+			for (uint64_t i = 0; i < missing; i++) {
+				swap(absent[i], absent[i + random.next() % (absent.size() - i)]);
+				edges.push_back(absent[i]);
+			}
+			continue;
+		}
+
+		for (uint64_t i = 0; i < missing; i++) {
+			int u, v;
+			if (skewed) {
+				double x = random.uniform() * weights.back();
+				u = ranked[min((size_t) (lower_bound(weights.begin(), weights.end(), x) - weights.begin()),
+				               ranked.size() - 1)];
+				int l = layerOf(u);
+				v = _layerStart[l + 1] + random.value(layerSize(l + 1));
+			} else {
+				uint64_t x = ((random.next() >> 11) * (double) capacity) / 9007199254740992.0;
+				int l = upper_bound(capacities.begin(), capacities.end(), x) - capacities.begin() - 1;
+				x -= capacities[l];
+				u = _layerStart[l] + (int) (x / layerSize(l + 1));
+				v = _layerStart[l + 1] + (int) (x % layerSize(l + 1));
+			}
+			edges.push_back(edgeKey(u, v));
+		}
+	}
+
+	// edges are sorted by parent, which is exactly a CSR by position
+	_degree.assign(_V, 0);
+	_offsets.assign(_V + 1, 0);
+	_targets.resize(edges.size());
+	for (size_t i = 0; i < edges.size(); i++) {
+		_degree[edges[i] >> 32]++;
+		_targets[i] = (int) (uint32_t) edges[i];
+	}
+	for (int u = 0; u < _V; u++) _offsets[u + 1] = _offsets[u] + _degree[u];
+	_E = edges.size();
+
+	cerr << _family << ": " << _V << " vertices, " << _E << " edges, depth " << _depth << ", width "
+	     << _width << endl;
+}
+
+// Calls emit(v) for every edge (u,v) of the graph being generated
+template <class Emit>
+void forEachEdge(int u, Emit emit) {
+	if (_family == "random") {
+		generateEdges(u, emit);
+	} else {
+		for (uint64_t i = _offsets[u]; i < _offsets[u + 1]; i++) emit(_targets[i]);
+	}
+}
+
+//-------------------------------------------------------------------
+
+void writeAll(const void* data, size_t size) {
+	const char* bytes = (const char*) data;
+	while (size > 0) {
+		ssize_t written = write(STDOUT_FILENO, bytes, size);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			cerr << "ERROR: could not write output: " << strerror(errno) << endl;
+			exit(EXIT_FAILURE);
+		}
+		bytes += written;
+		size -= written;
+	}
+}
+
+char* appendNumber(char* out, unsigned value) {
+	char digits[10];
+	int n = 0;
+	do { digits[n++] = '0' + value % 10; value /= 10; } while (value);
+	while (n) *out++ = digits[--n];
+	return out;
+}
+
+// Appends the edges of every ID in [first, last) to out, as text or as int32 children
+void formatChunk(int first, int last, vector<char>& out) {
+	out.clear();
+	for (int id = first; id < last; id++) {
+		int u = _ID2v[id];
+		size_t size = out.size();
+		out.resize(size + (size_t) _degree[u] * (_binary ? sizeof(int32_t) : 24));
+		char* cursor = out.data() + size;
+		forEachEdge(u, [&](int v) {
+			if (_binary) {
+				int32_t child = _v2ID[v] + 1;
+				memcpy(cursor, &child, sizeof(child));
+				cursor += sizeof(child);
+			} else {
+				cursor = appendNumber(cursor, id + 1);
+				*cursor++ = ' ';
+				cursor = appendNumber(cursor, _v2ID[v] + 1);
+				*cursor++ = '\n';
+			}
+		});
+		out.resize(cursor - out.data());
+	}
+}
+
+// Writes the edges in parent ID order: chunks of ~CHUNK_EDGES edges are formatted
+// _threads at a time and written in order, keeping memory bounded
+void writeEdges() {
+	vector<int> bounds(1, 0);
+	uint64_t edges = 0;
+	for (int id = 0; id < _V; id++) {
+		edges += _degree[_ID2v[id]];
+		if (edges >= CHUNK_EDGES || id + 1 == _V) {
+			bounds.push_back(id + 1);
+			edges = 0;
+		}
+	}
+
+	int chunks = bounds.size() - 1;
+	vector<vector<char> > buffers(_threads);
+	for (int round = 0; round < chunks; round += _threads) {
+		runThreads([&](int t) {
+			if (round + t < chunks) formatChunk(bounds[round + t], bounds[round + t + 1], buffers[t]);
+		});
+		for (int t = 0; t < _threads && round + t < chunks; t++)
+			writeAll(buffers[t].data(), buffers[t].size());
+	}
+}
+
+void writeBinaryHeader() {
+	binaryHeaderStruct header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BINARY_GRAPH_MAGIC, 8);
+	header.version = BINARY_GRAPH_VERSION;
+	header.flags = 0;
+	header.nodes = _V;
+	header.edges = _E;
+	header.adjacencyBytes = _E * sizeof(int32_t);
+	writeAll(&header, sizeof(header));
+
+	// Edge offsets, by ID
+	vector<uint64_t> offsets(_V + 1, 0);
+	for (int id = 0; id < _V; id++) offsets[id + 1] = offsets[id] + _degree[_ID2v[id]];
+	writeAll(offsets.data(), offsets.size() * sizeof(uint64_t));
 }
 
 int main(int argc, char *argv[]) {
 	// parse arguments
 	parseArgs(argc, argv);
 
-	// init vector of IDs (to be shuffled)
-	_v2ID = new int[_V];
+	// init vector of IDs and shuffle them (Fisher-Yates)
+	Random random(_seed, 0);
+	_v2ID.resize(_V);
 	for (int i = 0; i < _V; i++)
 		_v2ID[i] = i;
-	// shuffle IDs
-	for (int i = 0; i < _V; i++) {
-		int u = randomValue(_V);
-		int v = randomValue(_V);
-		int aux = _v2ID[u];
-		_v2ID[u] = _v2ID[v];
-		_v2ID[v] = aux;
-	}
-
-	// init graph
-	_g = new list<int>[_V];
-	// add edges
-	for (int i = 0; i < _V; i++) {
-		for (int j = i+1; j < _V; j++) {
-			addEdge(i, j);
-		}
+	for (int i = _V - 1; i > 0; i--)
+		swap(_v2ID[i], _v2ID[random.value(i + 1)]);
+	_ID2v.resize(_V);
+	for (int i = 0; i < _V; i++)
+		_ID2v[_v2ID[i]] = i;
+
+	if (_family != "random") {
+		buildStructured();
+	} else {
+		// count every vertex's edges, so the header can be written before them
+		_degree.assign(_V, 0);
+		atomic<int> next(0);
+		runThreads([&](int t) {
+			for (int first; (first = next.fetch_add(1024)) < _V; ) {
+				for (int u = first; u < min(first + 1024, _V); u++)
+					generateEdges(u, [&](int v) { _degree[u]++; });
+			}
+		});
+		for (int u = 0; u < _V; u++) _E += _degree[u];
 	}
 
-	// print header
-	cout << _V << " " << _E << endl;
-	// print edges (with _v2ID transformation)
-	for (int i = 0; i < _V; i++) {
-		for (list<int>::iterator it = _g[i].begin(); it != _g[i].end(); it++) {
-			cout << (_v2ID[i]+1) << " " << (_v2ID[*it]+1) << endl;
+	if (_binary) {
+		writeBinaryHeader();
+		writeEdges();
+		// pad adjacency to a multiple of 8 bytes
+		static const char padding[8] = {0};
+		writeAll(padding, (8 - (_E * sizeof(int32_t)) % 8) % 8);
+	} else {
+		if (_E > INT_MAX) {
+			cerr << "ERROR: " << _E << " edges do not fit in an edge list" << endl;
+			exit(EXIT_FAILURE);
 		}
+		// print header
+		char header[32];
+		writeAll(header, snprintf(header, sizeof(header), "%d %llu\n", _V, (unsigned long long) _E));
+		// print edges (with _v2ID transformation)
+		writeEdges();
 	}
 	return 0;
 }
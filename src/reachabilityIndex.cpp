@@ -0,0 +1,272 @@
+#include <atomic>
+#include <random>
+#include "parallel.h"
+#include "reachabilityIndex.h"
+
+
+using namespace std;
+
+
+/* Words of a row in a chunk of columns. Chunks are what workers split among themselves */
+#define CHUNK_WORDS 8
+
+
+/**
+ * @brief ReachabilityIndex constructor. Builds the bitsets or the interval labels.
+ *
+ * @param graph graph to be asked about. Must have its adjacency built and no cycles
+ * @param order every node in topological order
+ * @param options memory budget, labellings and workers
+ */
+ReachabilityIndex::ReachabilityIndex(const Graph* graph, const vector<int>& order,
+                                     const reachabilityOptionsStruct& options)
+    : _graph(graph), _position(graph->getNumberOfNodes()), _words(0), _labels(0), _traversal(0) {
+
+    size_t nodes = graph->getNumberOfNodes();
+    for (size_t i = 0; i < nodes; i++) this->_position[order[i]-1] = i;
+    int workers = options.workers > 0 ? options.workers : getDefaultWorkers();
+
+    /* Bitsets when every row fits, rounded up to whole chunks. Chunks are claimed one at a time,
+     * as the ones at the start of the order have more rows to fill */
+    size_t rowWords = (nodes + 63) / 64, words = min((size_t) CHUNK_WORDS, rowWords);
+    size_t chunks = words ? (rowWords + words - 1) / words : 0;
+    if (nodes > 0 && chunks * words * nodes * sizeof(uint64_t) <= options.memory) {
+        this->_words = words;
+        this->_bits.assign(chunks * words * nodes, 0);
+        atomic<size_t> next(0);
+        runWorkers(min(workers, (int) chunks), [&](int) {
+            for (size_t chunk; (chunk = next.fetch_add(1)) < chunks; )
+                this->buildChunk(order, chunk);
+        });
+        return;
+    }
+
+    /* Interval labels otherwise, every labelling built by a single worker */
+    this->_labels = max(1, options.labels);
+    this->_low.assign(this->_labels * nodes, 0);
+    this->_post.assign(this->_labels * nodes, 0);
+    this->_reachedBy.assign(nodes, 0);
+    atomic<int> next(0);
+    runWorkers(min(workers, this->_labels), [&](int) {
+        for (int label; (label = next.fetch_add(1)) < this->_labels; )
+            this->buildLabels(order, label);
+    });
+
+}
+
+
+/**
+ * @brief Fills the bitsets of a chunk of columns, going backwards in topological order.
+ *
+ * @param order every node in topological order
+ * @param chunk chunk to be filled
+ */
+void ReachabilityIndex::buildChunk(const vector<int>& order, size_t chunk) {
+
+    size_t nodes = this->_position.size(), words = this->_words;
+    size_t low = chunk * words * 64, high = min(nodes, low + words * 64);
+    uint64_t* bits = &this->_bits[chunk * words * nodes];
+
+    /* Positions after the chunk reach none of its columns, so their rows stay empty */
+    for (size_t i = high; i-- > 0; ) {
+        uint64_t* row = bits + i * words;
+        for (int child : this->_graph->getAdjacentNodes(order[i])) {
+            size_t position = this->_position[child-1];
+            if (position >= high) continue;
+            const uint64_t* childRow = bits + position * words;
+            for (size_t word = 0; word < words; word++) row[word] |= childRow[word];
+            if (position < low) continue;
+            row[(position - low) / 64] |= (uint64_t) 1 << (position - low) % 64;
+        }
+    }
+
+}
+
+
+/**
+ * @brief Fills one interval labelling through a DFS whose roots and children are visited from a
+ *        different rotation for every labelling.
+ *
+ * @param order every node in topological order
+ * @param label labelling to be filled
+ */
+void ReachabilityIndex::buildLabels(const vector<int>& order, int label) {
+
+    size_t nodes = this->_position.size();
+    int* low = &this->_low[label * nodes];
+    int* post = &this->_post[label * nodes];
+
+    /* Every labelling visits the roots in its own shuffled order (the first one keeps it as is) */
+    vector<int> roots;
+    for (int node : order) if (this->_graph->getNodeInDegree(node) == 0) roots.push_back(node);
+    mt19937 random(label);
+    if (label > 0) shuffle(roots.begin(), roots.end(), random);
+
+    /* Holds every node being visited and how many of its children it looked at. A node's children
+     * are looked at from an offset of its own, backwards on odd labellings */
+    vector<pair<int, size_t>> frames;
+    vector<bool> visited(nodes, false);
+    int rank = 0;
+    auto child = [&](int node, size_t seen) {
+        adjacencyViewStruct children = this->_graph->getAdjacentNodes(node);
+        size_t first = label ? ((unsigned) node * 2654435761u >> 7) % children.size() : 0;
+        size_t index = (first + seen) % children.size();
+        return children.begin()[label % 2 ? children.size() - 1 - index : index];
+    };
+
+    for (int root : roots) {
+
+        visited[root-1] = true;
+        frames.push_back(make_pair(root, 0));
+
+        while (!frames.empty()) {
+            pair<int, size_t>& frame = frames.back();
+            if (frame.second == this->_graph->getAdjacentNodes(frame.first).size()) {
+                post[frame.first-1] = ++rank;
+                frames.pop_back();
+                continue;
+            }
+            int next = child(frame.first, frame.second++);
+            if (visited[next-1]) continue;
+            visited[next-1] = true;
+            frames.push_back(make_pair(next, 0));
+        }
+
+    }
+
+    /* A node's interval starts at the lowest rank it reaches, so children are done first */
+    for (size_t i = nodes; i-- > 0; ) {
+        int node = order[i];
+        low[node-1] = post[node-1];
+        for (int child : this->_graph->getAdjacentNodes(node))
+            low[node-1] = min(low[node-1], low[child-1]);
+    }
+
+}
+
+
+/**
+ * @brief Tells whether every labelling allows a node to reach another one.
+ *
+ * @param from node pushed
+ * @param to node that may topple
+ * @return false if from surely does not reach to
+ */
+bool ReachabilityIndex::mayReach(int from, int to) const {
+
+    if (this->_position[from-1] >= this->_position[to-1]) return false;
+
+    size_t nodes = this->_position.size();
+    for (int label = 0; label < this->_labels; label++) {
+        const int* low = &this->_low[label * nodes];
+        const int* post = &this->_post[label * nodes];
+        if (low[to-1] < low[from-1] || post[to-1] > post[from-1]) return false;
+    }
+
+    return true;
+
+}
+
+
+/**
+ * @brief Tells whether pushing a piece topples another one.
+ *
+ * @param from node pushed
+ * @param to node that may topple
+ * @return true if to falls when from is pushed (always for from == to)
+ */
+bool ReachabilityIndex::reaches(int from, int to) {
+
+    if (from == to) return true;
+
+    /* The bit of to's position in from's row */
+    if (this->_words) {
+        size_t nodes = this->_position.size(), columns = this->_words * 64;
+        size_t position = this->_position[to-1], bit = position % columns;
+        size_t row = (position / columns * nodes + this->_position[from-1]) * this->_words;
+        return this->_bits[row + bit / 64] >> (bit % 64) & 1;
+    }
+
+    /* Walks only through nodes whose labels still allow reaching to */
+    if (!this->mayReach(from, to)) return false;
+    this->_traversal++;
+    this->_frontier.assign(1, from);
+    this->_reachedBy[from-1] = this->_traversal;
+
+    while (!this->_frontier.empty()) {
+        int current = this->_frontier.back();
+        this->_frontier.pop_back();
+        for (int child : this->_graph->getAdjacentNodes(current)) {
+            if (child == to) return true;
+            if (this->_reachedBy[child-1] == this->_traversal) continue;
+            if (!this->mayReach(child, to)) continue;
+            this->_reachedBy[child-1] = this->_traversal;
+            this->_frontier.push_back(child);
+        }
+    }
+
+    return false;
+
+}
+
+
+/**
+ * @brief Get the Reach Count object.
+ *
+ * @param node node value
+ * @return number of pieces that fall when this piece is pushed, itself included
+ */
+size_t ReachabilityIndex::getReachCount(int node) {
+
+    size_t reached = 1, nodes = this->_position.size();
+
+    /* Adds up the node's row across every chunk */
+    if (this->_words) {
+        size_t chunks = this->_bits.size() / (this->_words * nodes);
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            const uint64_t* row = &this->_bits[(chunk * nodes + this->_position[node-1]) *
+                                              this->_words];
+            for (size_t word = 0; word < this->_words; word++)
+                reached += __builtin_popcountll(row[word]);
+        }
+        return reached;
+    }
+
+    /* Labels cannot count, so every reached node is walked */
+    this->_traversal++;
+    this->_frontier.assign(1, node);
+    this->_reachedBy[node-1] = this->_traversal;
+
+    while (!this->_frontier.empty()) {
+        int current = this->_frontier.back();
+        this->_frontier.pop_back();
+        for (int child : this->_graph->getAdjacentNodes(current)) {
+            if (this->_reachedBy[child-1] == this->_traversal) continue;
+            this->_reachedBy[child-1] = this->_traversal;
+            this->_frontier.push_back(child);
+            reached++;
+        }
+    }
+
+    return reached;
+
+}
+
+
+/**
+ * @brief Tells whether the index holds bitsets, so every query is answered without a DFS.
+ *
+ * @return true with bitsets, false with interval labels
+ */
+bool ReachabilityIndex::hasBitsets() const { return this->_words > 0; }
+
+
+/**
+ * @brief Get the Bytes object.
+ *
+ * @return bytes taken by the bitsets and labels
+ */
+size_t ReachabilityIndex::getBytes() const {
+    return this->_bits.size() * sizeof(uint64_t) +
+           (this->_low.size() + this->_post.size()) * sizeof(int);
+}
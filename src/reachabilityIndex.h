@@ -0,0 +1,165 @@
+#ifndef REACHABILITY_INDEX_H
+#define REACHABILITY_INDEX_H
+
+#include <cstdint>
+#include "graph.h"
+
+
+using namespace std;
+
+
+/* Memory given to the reachability bitsets by default. Larger graphs get interval labels instead */
+#define REACHABILITY_MEMORY ((size_t) 256 << 20)
+
+/* Interval labellings built by default when the bitsets do not fit */
+#define REACHABILITY_LABELS 2
+
+
+/**
+ * @brief Holds how a reachability index trades memory for query time.
+ *
+ * @param memory bytes the bitsets may take. Graphs needing more get interval labels instead
+ * @param labels number of interval labellings, each cutting more queries short for 2 ints per node
+ * @param workers number of workers building the index, 0 to use every hardware thread
+ */
+typedef struct reachabilityOptionsStruct {
+    size_t memory;
+    int labels;
+    int workers;
+} reachabilityOptionsStruct;
+
+
+/**
+ * @brief Tells which pieces topple when a given one is pushed, built once over a graph placed
+ *        without cycles. Graphs small enough for the memory budget get one bitset per node over
+ *        the topological positions, split into chunks of columns that workers fill independently,
+ *        so every query is a bit test or a popcount. Larger graphs get interval labels from several
+ *        randomized DFS traversals (one per worker at a time): a node only reaches nodes whose
+ *        intervals nest inside its own and that come later in topological order, which answers
+ *        most negative queries at once and prunes the DFS answering the others.
+ */
+class ReachabilityIndex {
+
+    private:
+
+        /**
+         * @brief Holds the graph being asked about.
+         */
+        const Graph* _graph;
+
+        /**
+         * @brief Holds every node's topological position.
+         */
+        vector<int> _position;
+
+        /**
+         * @brief Holds the number of words of a row in a chunk of columns (0 without bitsets).
+         */
+        size_t _words;
+
+        /**
+         * @brief Holds one chunk of columns after the other, each with a row per position telling
+         *        which positions of the chunk it reaches.
+         */
+        vector<uint64_t> _bits;
+
+        /**
+         * @brief Holds the number of interval labellings.
+         */
+        int _labels;
+
+        /**
+         * @brief Holds every labelling's intervals, one labelling after the other: the lowest post
+         *        order rank reached from a node and the node's own rank.
+         */
+        vector<int> _low, _post;
+
+        /**
+         * @brief Holds, for every node, the last traversal that reached it. Tells reached nodes
+         *        apart without clearing anything between queries.
+         */
+        vector<unsigned> _reachedBy;
+
+        /**
+         * @brief Holds the number of the current traversal.
+         */
+        unsigned _traversal;
+
+        /**
+         * @brief Holds the nodes still to be expanded by the current traversal.
+         */
+        vector<int> _frontier;
+
+        /**
+         * @brief Fills the bitsets of a chunk of columns, going backwards in topological order.
+         *
+         * @param order every node in topological order
+         * @param chunk chunk to be filled
+         */
+        void buildChunk(const vector<int>& order, size_t chunk);
+
+        /**
+         * @brief Fills one interval labelling through a DFS whose roots and children are visited
+         *        from a different rotation for every labelling.
+         *
+         * @param order every node in topological order
+         * @param label labelling to be filled
+         */
+        void buildLabels(const vector<int>& order, int label);
+
+        /**
+         * @brief Tells whether every labelling allows a node to reach another one.
+         *
+         * @param from node pushed
+         * @param to node that may topple
+         * @return false if from surely does not reach to
+         */
+        bool mayReach(int from, int to) const;
+
+    public:
+
+        /**
+         * @brief ReachabilityIndex constructor. Builds the bitsets or the interval labels.
+         *
+         * @param graph graph to be asked about. Must have its adjacency built and no cycles
+         * @param order every node in topological order
+         * @param options memory budget, labellings and workers
+         */
+        ReachabilityIndex(const Graph* graph, const vector<int>& order,
+                          const reachabilityOptionsStruct& options);
+
+        /**
+         * @brief Tells whether pushing a piece topples another one.
+         *
+         * @param from node pushed
+         * @param to node that may topple
+         * @return true if to falls when from is pushed (always for from == to)
+         */
+        bool reaches(int from, int to);
+
+        /**
+         * @brief Get the Reach Count object.
+         *
+         * @param node node value
+         * @return number of pieces that fall when this piece is pushed, itself included
+         */
+        size_t getReachCount(int node);
+
+        /**
+         * @brief Tells whether the index holds bitsets, so every query is answered without a DFS.
+         *
+         * @return true with bitsets, false with interval labels
+         */
+        bool hasBitsets() const;
+
+        /**
+         * @brief Get the Bytes object.
+         *
+         * @return bytes taken by the bitsets and labels
+         */
+        size_t getBytes() const;
+
+};
+
+
+#endif // REACHABILITY_INDEX_H
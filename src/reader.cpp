@@ -0,0 +1,581 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "binaryGraph.h"
+#include "parallel.h"
+#include "reader.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Number of bytes requested at a time when the input cannot be mapped.
+ */
+#define READ_BLOCK_SIZE (1 << 22)
+
+
+/**
+ * @brief Minimum number of bytes given to each worker. Smaller inputs use fewer workers.
+ */
+#define MIN_CHUNK_SIZE (1 << 20)
+
+
+/**
+ * @brief Holds what a worker learns about its chunk of the edge list.
+ *
+ * @param begin position of the chunk's first byte
+ * @param end position past the chunk's last byte
+ * @param edges number of well formed edges read from this chunk
+ * @param parents every edge's parent, in input order. Later turned into the edge's rank among its
+ *        parent's children
+ * @param error first malformed line of this chunk, empty if there was none
+ */
+typedef struct chunkStruct {
+    const char* begin;
+    const char* end;
+    int edges;
+    vector<int> parents;
+    string error;
+} chunkStruct;
+
+
+/**
+ * @brief InputBuffer constructor. Reads everything available from the file descriptor.
+ *
+ * @param fd file descriptor to read from
+ */
+InputBuffer::InputBuffer(int fd) : _mapped(nullptr), _size(0) {
+
+    /* Regular files are mapped, so their pages are only brought in as the parser walks them */
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+            this->_mapped = static_cast<char*>(mapped);
+            this->_size = info.st_size;
+            return;
+        }
+    }
+
+    /* Anything else is read in large blocks until there is nothing left */
+    while (true) {
+        if (this->_block.size() < this->_size + READ_BLOCK_SIZE)
+            this->_block.resize(max(this->_block.size() * 2, this->_size + READ_BLOCK_SIZE));
+        char* free = this->_block.data() + this->_size;
+        ssize_t bytes = read(fd, free, this->_block.size() - this->_size);
+        if (bytes == 0) break;
+        if (bytes < 0) {
+            if (errno == EINTR) continue;
+            this->_error = string("could not read input: ") + strerror(errno);
+            break;
+        }
+        this->_size += bytes;
+    }
+
+}
+
+
+/**
+ * @brief InputBuffer destructor. Unmaps the input if it was mapped.
+ */
+InputBuffer::~InputBuffer() { if (this->_mapped != nullptr) munmap(this->_mapped, this->_size); }
+
+
+/**
+ * @brief Get the Begin object.
+ *
+ * @return pointer to the first byte of the input
+ */
+const char* InputBuffer::getBegin() const {
+    return this->_mapped != nullptr ? this->_mapped : this->_block.data();
+}
+
+
+/**
+ * @brief Get the End object.
+ *
+ * @return pointer past the last byte of the input
+ */
+const char* InputBuffer::getEnd() const { return this->getBegin() + this->_size; }
+
+
+/**
+ * @brief Get the Error object.
+ *
+ * @return description of the reading error, empty if there was none
+ */
+const string& InputBuffer::getError() const { return this->_error; }
+
+
+/**
+ * @brief EdgeListParser constructor.
+ *
+ * @param begin pointer to the first byte of the input
+ * @param end pointer past the last byte of the input
+ */
+EdgeListParser::EdgeListParser(const char* begin, const char* end)
+    : _begin(begin), _cursor(begin), _end(end), _edges(begin) {}
+
+
+/**
+ * @brief Records a parsing error at the given position.
+ *
+ * @param at position of the offending byte
+ * @param message description of what was expected
+ * @return false, so it can be returned directly
+ */
+bool EdgeListParser::fail(const char* at, const string& message) {
+    this->_error = "malformed input at byte " + to_string(at - this->_begin) + ": " + message;
+    return false;
+}
+
+
+/**
+ * @brief Skips every whitespace (including new lines) before the next token.
+ */
+void EdgeListParser::skipWhitespace() {
+    while (this->_cursor != this->_end && (unsigned char) *this->_cursor <= ' ') this->_cursor++;
+}
+
+
+/**
+ * @brief Skips spaces and tabs, stopping at new lines.
+ */
+void EdgeListParser::skipBlanks() {
+    while (this->_cursor != this->_end && (*this->_cursor == ' ' || *this->_cursor == '\t'))
+        this->_cursor++;
+}
+
+
+/**
+ * @brief Reads a positive number, checking it is well formed.
+ *
+ * @param value where the number is stored
+ * @return true if a number was read
+ */
+bool EdgeListParser::readNumber(int& value) {
+
+    const char* start = this->_cursor;
+    unsigned long long number = 0;
+    unsigned digit;
+
+    /* A single unsigned comparison tells digits apart from anything else */
+    while (this->_cursor != this->_end && (digit = *this->_cursor - '0') < 10) {
+        number = number * 10 + digit;
+        this->_cursor++;
+        if (number > INT_MAX) return this->fail(start, "number does not fit in an int");
+    }
+
+    if (this->_cursor == start) {
+        if (this->_cursor == this->_end) return this->fail(start, "unexpected end of input");
+        return this->fail(start, string("expected a number, found '") + *start + "'");
+    }
+
+    value = (int) number;
+    return true;
+
+}
+
+
+/**
+ * @brief Reads one "parent child" line, checking it is well formed and its nodes exist.
+ *
+ * @param nodes number of nodes inside graph
+ * @param parent where parent's node is stored
+ * @param child where child's node is stored
+ * @return true if the edge was read
+ */
+bool EdgeListParser::readEdge(int nodes, int& parent, int& child) {
+
+    this->skipWhitespace();
+    const char* start = this->_cursor;
+    if (!this->readNumber(parent)) return false;
+
+    /* Both nodes must be on the same line */
+    this->skipBlanks();
+    if (this->_cursor != this->_end && (*this->_cursor == '\n' || *this->_cursor == '\r'))
+        return this->fail(this->_cursor, "expected child node before end of line");
+
+    const char* second = this->_cursor;
+    if (!this->readNumber(child)) return false;
+
+    /* Nothing else may follow on this line */
+    this->skipBlanks();
+    if (this->_cursor != this->_end && *this->_cursor == '\r') this->_cursor++;
+    if (this->_cursor != this->_end && *this->_cursor != '\n')
+        return this->fail(this->_cursor, "expected end of line after edge");
+
+    /* Both nodes must exist inside the graph */
+    if (parent < 1 || parent > nodes)
+        return this->fail(start, "parent node " + to_string(parent) + " is not in [1, " +
+                          to_string(nodes) + "]");
+    if (child < 1 || child > nodes)
+        return this->fail(second, "child node " + to_string(child) + " is not in [1, " +
+                          to_string(nodes) + "]");
+
+    return true;
+
+}
+
+
+/**
+ * @brief Reads the next number without any checks. Only used on input already validated.
+ *
+ * @return number read
+ */
+int EdgeListParser::readTrustedNumber() {
+
+    this->skipWhitespace();
+
+    int number = 0;
+    unsigned digit;
+    while (this->_cursor != this->_end && (digit = *this->_cursor - '0') < 10) {
+        number = number * 10 + digit;
+        this->_cursor++;
+    }
+
+    return number;
+
+}
+
+
+/**
+ * @brief Reads the "nNodes nEdges" header.
+ *
+ * @param nodes where the number of nodes is stored
+ * @param edges where the number of edges is stored
+ * @return true if the header was read
+ */
+bool EdgeListParser::readHeader(int& nodes, int& edges) {
+
+    this->skipWhitespace();
+    if (!this->readNumber(nodes)) return false;
+    this->skipWhitespace();
+    if (!this->readNumber(edges)) return false;
+
+    this->_edges = this->_cursor;
+    return true;
+
+}
+
+
+/**
+ * @brief Skips over the next instance of a stream of concatenated edge lists without validating it,
+ *        so that the instances can be told apart cheaply and parsed later, each one from its own
+ *        start.
+ *
+ * @return first byte of the skipped instance, nullptr if only whitespace was left
+ */
+const char* EdgeListParser::skipInstance() {
+
+    this->skipWhitespace();
+    if (this->_cursor == this->_end) return nullptr;
+    const char* start = this->_cursor;
+
+    /* The number of nodes is not needed. Skipping it as a token always moves forward, so a
+     * malformed header still ends up as an instance of its own (reported when it is parsed) */
+    while (this->_cursor != this->_end && (unsigned char) *this->_cursor > ' ') this->_cursor++;
+    int edges = this->readTrustedNumber();
+
+    /* Every edge is two tokens, wherever the new lines are */
+    for (long long token = 0; token < 2LL * edges; token++) {
+        this->skipWhitespace();
+        while (this->_cursor != this->_end && (unsigned char) *this->_cursor > ' ') this->_cursor++;
+    }
+
+    return start;
+
+}
+
+
+/**
+ * @brief Moves the parser to a position of its input, e.g. an instance found by skipInstance. Byte
+ *        offsets in errors stay relative to the input's first byte.
+ *
+ * @param position next byte to be parsed
+ */
+void EdgeListParser::seek(const char* position) {
+    this->_cursor = position;
+    this->_edges = position;
+    this->_error.clear();
+}
+
+
+/**
+ * @brief Validates every edge and counts their degrees inside the graph (first pass).
+ *
+ * @param graph graph whose degrees are counted
+ * @param edges number of edges to read
+ * @return true if every edge was well formed
+ */
+bool EdgeListParser::countEdges(Graph* graph, int edges) {
+
+    int nodes = graph->getNumberOfNodes(), parent = 0, child = 0;
+
+    this->_cursor = this->_edges;
+    for (int i = 0; i < edges; i++) {
+        if (!this->readEdge(nodes, parent, child)) return false;
+        graph->countEdge(parent, child);
+    }
+
+    return true;
+
+}
+
+
+/**
+ * @brief Places every edge inside the graph's adjacency (second pass). Must only be called after
+ *        countEdges succeeded.
+ *
+ * @param graph graph being filled
+ * @param edges number of edges to read
+ */
+void EdgeListParser::placeEdges(Graph* graph, int edges) {
+
+    this->_cursor = this->_edges;
+    for (int i = 0; i < edges; i++) {
+        int parent = this->readTrustedNumber();
+        int child = this->readTrustedNumber();
+        graph->placeEdge(parent, child);
+    }
+
+}
+
+
+/**
+ * @brief Validates the edges from a position up to the end of this parser's input and records each
+ *        one's parent, in input order. Stops early at the limit or at the first malformed line,
+ *        which is kept as this parser's error.
+ *
+ * @param from position of the first edge
+ * @param nodes number of nodes inside graph
+ * @param limit maximum number of edges to read
+ * @param parents receives the parent of every edge read (anything held before is dropped)
+ * @return number of well formed edges read
+ */
+int EdgeListParser::countRange(const char* from, int nodes, int limit, vector<int>* parents) {
+
+    int edges = 0, parent = 0, child = 0;
+
+    parents->clear();
+    this->_cursor = from;
+    while (edges < limit) {
+
+        /* Running out of input is not an error here, the chunk simply ended */
+        this->skipWhitespace();
+        if (this->_cursor == this->_end) break;
+
+        if (!this->readEdge(nodes, parent, child)) break;
+        parents->push_back(parent);
+        edges++;
+
+    }
+
+    return edges;
+
+}
+
+
+/**
+ * @brief Places the edges recorded by countRange inside the graph's adjacency and counts their
+ *        children's in degrees.
+ *
+ * @param from position of the first edge
+ * @param edges number of edges to read
+ * @param ranks every edge's position among its parent's children
+ * @param inDegree per node in degrees shared by every worker, incremented for every child
+ * @param graph graph being filled
+ */
+void EdgeListParser::placeRange(const char* from, int edges, const int* ranks,
+                                atomic<int>* inDegree, Graph* graph) {
+
+    this->_cursor = from;
+    for (int i = 0; i < edges; i++) {
+        int parent = this->readTrustedNumber();
+        int child = this->readTrustedNumber();
+        graph->placeEdgeAt(graph->getAdjacencyStart(parent) + ranks[i], child);
+        inDegree[child-1].fetch_add(1, memory_order_relaxed);
+    }
+
+}
+
+
+/**
+ * @brief Reads every edge after the header and builds the graph's adjacency on the calling thread.
+ *
+ * @param graph graph being filled
+ * @param edges number of edges to read
+ * @return true if every edge was well formed
+ */
+bool EdgeListParser::loadEdges(Graph* graph, int edges) {
+
+    /* Counts every node's degrees while validating the edges, then fills the adjacency by parsing
+     * the edges a second time straight from the buffer */
+    if (!this->countEdges(graph, edges)) return false;
+    graph->allocateAdjacency();
+    this->placeEdges(graph, edges);
+    graph->finishAdjacency();
+
+    return true;
+
+}
+
+
+/**
+ * @brief Reads every edge after the header and builds the graph's adjacency with several workers.
+ *        The input is split on line boundaries and every worker validates its own chunk, recording
+ *        each edge's parent. One pass over those parents, chunk after chunk, gives every edge its
+ *        rank among its parent's children, so the workers then fill the adjacency in input order
+ *        while counting in degrees into a shared array. Memory grows with nodes + edges, not with
+ *        workers * nodes. The result is the same as loadEdges.
+ *
+ * @param graph graph being filled
+ * @param edges number of edges to read
+ * @param workers number of workers
+ * @return true if every edge was well formed
+ */
+bool EdgeListParser::loadEdgesParallel(Graph* graph, int edges, int workers) {
+
+    int nodes = graph->getNumberOfNodes();
+    size_t bytes = this->_end - this->_edges;
+
+    /* Splits the edges in one chunk per worker. Every chunk ends right after a new line, so no
+     * line is ever shared between two workers */
+    vector<chunkStruct> chunks(workers);
+    const char* start = this->_edges;
+    for (int worker = 0; worker < workers; worker++) {
+        const char* stop = this->_edges + bytes * (worker + 1) / workers;
+        while (stop < this->_end && stop > start && stop[-1] != '\n') stop++;
+        if (stop < start) stop = start;
+        chunks[worker].begin = start;
+        chunks[worker].end = stop;
+        start = stop;
+    }
+
+    /* First pass: every worker validates its chunk and records its edges' parents */
+    auto count = [&](int worker, int limit) {
+        chunkStruct& chunk = chunks[worker];
+        EdgeListParser parser(this->_begin, chunk.end);
+        chunk.edges = parser.countRange(chunk.begin, nodes, limit, &chunk.parents);
+        chunk.error = parser.getError();
+    };
+    runWorkers(workers, [&](int worker) { count(worker, INT_MAX); });
+
+    /* Only the first nEdges edges belong to the graph, just like when reading them one by one.
+     * Chunks going past that amount are counted again up to it and the remaining ones dropped, so
+     * errors after the last edge are ignored as well */
+    int read = 0;
+    for (int worker = 0; worker < workers; worker++) {
+        chunkStruct& chunk = chunks[worker];
+        int missing = edges - read;
+        if (chunk.edges > missing || (chunk.edges > 0 && missing == 0)) count(worker, missing);
+        else if (chunk.edges == missing) chunk.error.clear();
+        if (!chunk.error.empty()) {
+            this->_error = chunk.error;
+            return false;
+        }
+        read += chunk.edges;
+    }
+    if (read < edges)
+        return this->fail(this->_end, "unexpected end of input after " + to_string(read) +
+                                      " of " + to_string(edges) + " edges");
+
+    /* Each node's children are laid out chunk after chunk, in input order, so every parent is
+     * replaced by how many children its node already had. This only touches one counter per edge */
+    vector<size_t> outDegree(nodes, 0);
+    for (auto& chunk : chunks)
+        for (int& parent : chunk.parents) parent = (int) outDegree[parent-1]++;
+
+    /* Workers own disjoint ranges of nodes while degrees are added to the graph */
+    auto addDegrees = [&](function<void(int)> add) {
+        runWorkers(workers, [&](int worker) {
+            int first = (int) ((long long) nodes * worker / workers);
+            int last = (int) ((long long) nodes * (worker + 1) / workers);
+            for (int node = first; node < last; node++) add(node);
+        });
+    };
+    addDegrees([&](int node) { graph->addNodeDegrees(node + 1, outDegree[node], 0); });
+    graph->allocateAdjacency();
+
+    /* Second pass: every worker fills its own positions of the adjacency. In degrees are shared,
+     * their order does not matter, so relaxed increments are enough */
+    vector<atomic<int>> inDegree(nodes);
+    runWorkers(workers, [&](int worker) {
+        chunkStruct& chunk = chunks[worker];
+        EdgeListParser parser(this->_begin, chunk.end);
+        parser.placeRange(chunk.begin, chunk.edges, chunk.parents.data(), inDegree.data(), graph);
+    });
+    addDegrees([&](int node) {
+        graph->addNodeDegrees(node + 1, 0, inDegree[node].load(memory_order_relaxed));
+    });
+    graph->finishAdjacency();
+
+    return true;
+
+}
+
+
+/**
+ * @brief Get the Error object.
+ *
+ * @return description of the first malformed input, including its byte offset
+ */
+const string& EdgeListParser::getError() const { return this->_error; }
+
+
+/**
+ * @brief Reads an edge list, or a binary graph, and builds its graph, reporting malformed input on
+ *        stderr.
+ *
+ * @param fd file descriptor to read from
+ * @param workers number of workers used to parse the edges, 0 to use every hardware thread
+ * @return newly created graph. Terminates the program if the input is malformed
+ */
+Graph readGraph(int fd, int workers) {
+
+    /* Holds number of nodes and edges from the header */
+    int nNodes = 0, nEdges = 0;
+
+    shared_ptr<InputBuffer> input = make_shared<InputBuffer>(fd);
+    if (!input->getError().empty()) {
+        cerr << input->getError() << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /* Binary graphs need no parsing at all. The graph keeps the input alive since it may use it */
+    if (isBinaryGraph(input->getBegin(), input->getEnd())) {
+        string error;
+        unique_ptr<Graph> graph = loadBinaryGraph(input, input->getBegin(), input->getEnd(), error);
+        if (!graph) {
+            cerr << error << endl;
+            exit(EXIT_FAILURE);
+        }
+        return move(*graph);
+    }
+
+    EdgeListParser parser(input->getBegin(), input->getEnd());
+    if (!parser.readHeader(nNodes, nEdges)) {
+        cerr << parser.getError() << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /* Small inputs are not worth splitting */
+    if (workers <= 0) workers = getDefaultWorkers();
+    size_t bytes = input->getEnd() - input->getBegin();
+    workers = (int) max((size_t) 1, min((size_t) workers, bytes / MIN_CHUNK_SIZE));
+
+    /* Every buffer of the graph, and of the traversal that follows, comes from a single arena */
+    Graph graph(nNodes, nEdges, make_shared<Arena>(Graph::getArenaBytes(nNodes, nEdges)));
+    bool loaded = workers > 1 ? parser.loadEdgesParallel(&graph, nEdges, workers)
+                              : parser.loadEdges(&graph, nEdges);
+    if (!loaded) {
+        cerr << parser.getError() << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return graph;
+
+}
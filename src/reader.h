@@ -0,0 +1,285 @@
+#ifndef READER_H
+#define READER_H
+
+#include <atomic>
+#include <string>
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Holds the raw bytes of an edge list input. Regular files are mapped into memory and any
+ *        other input (pipes, terminals) is read in large blocks.
+ */
+class InputBuffer {
+
+    private:
+
+        /**
+         * @brief Holds the mapped file, or nullptr when the input was read into _block.
+         */
+        char* _mapped;
+
+        /**
+         * @brief Holds the input when it could not be mapped.
+         */
+        vector<char> _block;
+
+        /**
+         * @brief Holds number of bytes in the input.
+         */
+        size_t _size;
+
+        /**
+         * @brief Holds a description of what went wrong while reading, empty if nothing did.
+         */
+        string _error;
+
+    public:
+
+        /**
+         * @brief InputBuffer constructor. Reads everything available from the file descriptor.
+         *
+         * @param fd file descriptor to read from
+         */
+        explicit InputBuffer(int fd);
+
+        /**
+         * @brief InputBuffer destructor. Unmaps the input if it was mapped.
+         */
+        ~InputBuffer();
+
+        InputBuffer(const InputBuffer&) = delete;
+        InputBuffer& operator=(const InputBuffer&) = delete;
+
+        /**
+         * @brief Get the Begin object.
+         *
+         * @return pointer to the first byte of the input
+         */
+        const char* getBegin() const;
+
+        /**
+         * @brief Get the End object.
+         *
+         * @return pointer past the last byte of the input
+         */
+        const char* getEnd() const;
+
+        /**
+         * @brief Get the Error object.
+         *
+         * @return description of the reading error, empty if there was none
+         */
+        const string& getError() const;
+
+};
+
+
+/**
+ * @brief Parses an edge list ("nNodes nEdges" header followed by one "parent child" pair per line)
+ *        straight from memory, building the graph's CSR adjacency in two passes over the buffer.
+ */
+class EdgeListParser {
+
+    private:
+
+        /**
+         * @brief Holds the first byte of the input. Used to report byte offsets.
+         */
+        const char* _begin;
+
+        /**
+         * @brief Holds the next byte to be parsed.
+         */
+        const char* _cursor;
+
+        /**
+         * @brief Holds the byte past the end of the input.
+         */
+        const char* _end;
+
+        /**
+         * @brief Holds where the edges start, right after the header.
+         */
+        const char* _edges;
+
+        /**
+         * @brief Holds a description of the first malformed input found, empty if there was none.
+         */
+        string _error;
+
+        /**
+         * @brief Records a parsing error at the given position.
+         *
+         * @param at position of the offending byte
+         * @param message description of what was expected
+         * @return false, so it can be returned directly
+         */
+        bool fail(const char* at, const string& message);
+
+        /**
+         * @brief Skips every whitespace (including new lines) before the next token.
+         */
+        void skipWhitespace();
+
+        /**
+         * @brief Skips spaces and tabs, stopping at new lines.
+         */
+        void skipBlanks();
+
+        /**
+         * @brief Reads a positive number, checking it is well formed.
+         *
+         * @param value where the number is stored
+         * @return true if a number was read
+         */
+        bool readNumber(int& value);
+
+        /**
+         * @brief Reads one "parent child" line, checking it is well formed and its nodes exist.
+         *
+         * @param nodes number of nodes inside graph
+         * @param parent where parent's node is stored
+         * @param child where child's node is stored
+         * @return true if the edge was read
+         */
+        bool readEdge(int nodes, int& parent, int& child);
+
+        /**
+         * @brief Reads the next number without any checks. Only used on input already validated.
+         *
+         * @return number read
+         */
+        int readTrustedNumber();
+
+    public:
+
+        /**
+         * @brief EdgeListParser constructor.
+         *
+         * @param begin pointer to the first byte of the input
+         * @param end pointer past the last byte of the input
+         */
+        EdgeListParser(const char* begin, const char* end);
+
+        /**
+         * @brief Reads the "nNodes nEdges" header.
+         *
+         * @param nodes where the number of nodes is stored
+         * @param edges where the number of edges is stored
+         * @return true if the header was read
+         */
+        bool readHeader(int& nodes, int& edges);
+
+        /**
+         * @brief Skips over the next instance of a stream of concatenated edge lists without
+         *        validating it, so that the instances can be told apart cheaply and parsed later,
+         *        each one from its own start.
+         *
+         * @return first byte of the skipped instance, nullptr if only whitespace was left
+         */
+        const char* skipInstance();
+
+        /**
+         * @brief Moves the parser to a position of its input, e.g. an instance found by
+         *        skipInstance. Byte offsets in errors stay relative to the input's first byte.
+         *
+         * @param position next byte to be parsed
+         */
+        void seek(const char* position);
+
+        /**
+         * @brief Validates every edge and counts their degrees inside the graph (first pass).
+         *
+         * @param graph graph whose degrees are counted
+         * @param edges number of edges to read
+         * @return true if every edge was well formed
+         */
+        bool countEdges(Graph* graph, int edges);
+
+        /**
+         * @brief Places every edge inside the graph's adjacency (second pass). Must only be called
+         *        after countEdges succeeded.
+         *
+         * @param graph graph being filled
+         * @param edges number of edges to read
+         */
+        void placeEdges(Graph* graph, int edges);
+
+        /**
+         * @brief Validates the edges from a position up to the end of this parser's input and
+         *        records each one's parent, in input order. Stops early at the limit or at the
+         *        first malformed line, which is kept as this parser's error.
+         *
+         * @param from position of the first edge
+         * @param nodes number of nodes inside graph
+         * @param limit maximum number of edges to read
+         * @param parents receives the parent of every edge read (anything held before is dropped)
+         * @return number of well formed edges read
+         */
+        int countRange(const char* from, int nodes, int limit, vector<int>* parents);
+
+        /**
+         * @brief Places the edges recorded by countRange inside the graph's adjacency and counts
+         *        their children's in degrees.
+         *
+         * @param from position of the first edge
+         * @param edges number of edges to read
+         * @param ranks every edge's position among its parent's children
+         * @param inDegree per node in degrees shared by every worker, incremented for every child
+         * @param graph graph being filled
+         */
+        void placeRange(const char* from, int edges, const int* ranks, atomic<int>* inDegree,
+                        Graph* graph);
+
+        /**
+         * @brief Reads every edge after the header and builds the graph's adjacency on the calling
+         *        thread.
+         *
+         * @param graph graph being filled
+         * @param edges number of edges to read
+         * @return true if every edge was well formed
+         */
+        bool loadEdges(Graph* graph, int edges);
+
+        /**
+         * @brief Reads every edge after the header and builds the graph's adjacency with several
+         *        workers. The input is split on line boundaries and every worker validates its own
+         *        chunk, recording each edge's parent. One pass over those parents, chunk after
+         *        chunk, gives every edge its rank among its parent's children, so the workers then
+         *        fill the adjacency in input order while counting in degrees into a shared array.
+         *        Memory grows with nodes + edges, not with workers * nodes. The result is the same
+         *        as loadEdges.
+         *
+         * @param graph graph being filled
+         * @param edges number of edges to read
+         * @param workers number of workers
+         * @return true if every edge was well formed
+         */
+        bool loadEdgesParallel(Graph* graph, int edges, int workers);
+
+        /**
+         * @brief Get the Error object.
+         *
+         * @return description of the first malformed input, including its byte offset
+         */
+        const string& getError() const;
+
+};
+
+
+/**
+ * @brief Reads an edge list, or a binary graph, and builds its graph, reporting malformed input on
+ *        stderr.
+ *
+ * @param fd file descriptor to read from
+ * @param workers number of workers used to parse the edges, 0 to use every hardware thread
+ * @return newly created graph. Terminates the program if the input is malformed
+ */
+Graph readGraph(int fd, int workers = 0);
+
+
+#endif // READER_H
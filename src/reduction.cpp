@@ -0,0 +1,142 @@
+#include <cstdint>
+#include "reduction.h"
+#include "relabel.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Builds the transitive reduction of a graph placed without cycles: an edge is dropped when
+ *        its child can also be reached through another child, so every piece still falls, no piece
+ *        gains or loses a parent of its own and the longest sequence is unchanged (a dropped edge
+ *        always skips a longer way around). Reachability is kept in bitsets over the topological
+ *        positions, one block of positions at a time, so memory stays within the given budget;
+ *        every node only ORs the bitsets of the children it keeps, which on dense graphs are few.
+ *        Repeated edges are dropped as well. The copy gets its own arena and keeps node numbers.
+ *        Exact reduction costs about nodes * nodes / 64 word operations, so large sparse graphs may
+ *        limit how far back a block looks for parents: edges coming from further away are kept,
+ *        which leaves some implied edges in but never changes any answer.
+ *
+ * @param graph graph to be reduced
+ * @param order every node in topological order, as given by getRelabelOrder
+ * @param memory bytes the reachability bitsets may take
+ * @param window how many positions before a block its parents are looked for (0 for all of them)
+ * @param pruned receives the number of edges dropped
+ * @return reduced graph
+ */
+Graph reduceGraph(const Graph* graph, const vector<int>& order, size_t memory, size_t window,
+                  size_t* pruned) {
+
+    int nodes = graph->getNumberOfNodes();
+
+    /* Holds every node's topological position */
+    vector<int> position(nodes);
+    for (int i = 0; i < nodes; i++) position[order[i]-1] = i;
+
+    /* Holds every position's children as positions, sorted, so a child can only be reached through
+     * the ones before it. Children kept are moved to the front of their node's range */
+    vector<size_t> start(nodes + 1, 0);
+    for (int i = 0; i < nodes; i++)
+        start[i+1] = start[i] + graph->getAdjacentNodes(order[i]).size();
+    vector<int> children(start[nodes]);
+    for (int i = 0; i < nodes; i++) {
+        size_t next = start[i];
+        for (int child : graph->getAdjacentNodes(order[i])) children[next++] = position[child-1];
+        sort(children.begin() + start[i], children.begin() + start[i+1]);
+    }
+
+    /* Holds how many children of each position were kept and the first one not looked at yet */
+    vector<size_t> kept(nodes, 0), next(start.begin(), start.end() - 1);
+
+    /* Every position gets a row of bits telling which positions of the current block it reaches */
+    size_t words = max((size_t) 1, min(((size_t) nodes + 63) / 64, memory / 8 / max(nodes, 1)));
+    vector<uint64_t> reach((size_t) nodes * words);
+
+    /* Blocks go forward, so when one starts, every child before it has already been kept or
+     * dropped. Positions go backwards, so every child's row is ready before its parents need it */
+    for (int low = 0; low < nodes; low += (int) words * 64) {
+
+        int high = (int) min((size_t) nodes, low + words * 64);
+        int first = window == 0 || (size_t) low <= window ? 0 : low - (int) window;
+        size_t used = ((size_t) (high - low) + 63) / 64;
+
+        for (int i = high - 1; i >= first; i--) {
+
+            uint64_t* row = &reach[(size_t) i * words];
+            fill(row, row + used, 0);
+
+            /* Children kept in earlier blocks may reach this one */
+            for (size_t k = start[i]; k < start[i] + kept[i]; k++) {
+                const uint64_t* childRow = &reach[(size_t) children[k] * words];
+                for (size_t word = 0; word < used; word++) row[word] |= childRow[word];
+            }
+
+            /* A child of this block already reached through an earlier child is dropped */
+            for (; next[i] < start[i+1] && children[next[i]] < high; next[i]++) {
+
+                int child = children[next[i]], bit = child - low;
+                if (row[bit / 64] >> (bit % 64) & 1) continue;
+
+                row[bit / 64] |= (uint64_t) 1 << (bit % 64);
+                const uint64_t* childRow = &reach[(size_t) child * words];
+                for (size_t word = 0; word < used; word++) row[word] |= childRow[word];
+                children[start[i] + kept[i]++] = child;
+
+            }
+
+        }
+
+    }
+
+    /* Children never looked at, as their parent was out of every window reaching them, are kept */
+    size_t edges = 0;
+    for (int i = 0; i < nodes; i++) {
+        for (; next[i] < start[i+1]; next[i]++) children[start[i] + kept[i]++] = children[next[i]];
+        edges += kept[i];
+    }
+    *pruned = graph->getNumberOfEdges() - edges;
+
+    /* Every node keeps its number and its children stay in topological order */
+    Graph reduced(nodes, edges, make_shared<Arena>(Graph::getArenaBytes(nodes, edges)));
+    for (int i = 0; i < nodes; i++)
+        for (size_t k = start[i]; k < start[i] + kept[i]; k++)
+            reduced.countEdge(order[i], order[children[k]]);
+
+    reduced.allocateAdjacency();
+    for (int i = 0; i < nodes; i++)
+        for (size_t k = start[i]; k < start[i] + kept[i]; k++)
+            reduced.placeEdge(order[i], order[children[k]]);
+    reduced.finishAdjacency();
+
+    return reduced;
+
+}
+
+
+/**
+ * @brief Replaces a graph by its transitive reduction, ordering it with a DFS first. Graphs placed
+ *        with cycles have no single reduction, so they are left as they are (and marked as cyclic).
+ *
+ * @param graph graph to be reduced
+ * @param pruned receives the number of edges dropped
+ * @param window how many positions before a block its parents are looked for (0 for all of them)
+ * @param memory bytes the reachability bitsets may take
+ * @return whether the graph was reduced
+ */
+bool reduceTransitiveEdges(Graph* graph, size_t* pruned, size_t window, size_t memory) {
+
+    vector<int> order = getRelabelOrder(graph, "dfs");
+    *pruned = 0;
+
+    /* The graph is kept, so it is left unvisited for the solvers' own DFS */
+    if (graph->hasCycle()) {
+        for (int node = 1; node <= graph->getNumberOfNodes(); node++)
+            graph->setNodeColor(node, Color::white);
+        return false;
+    }
+
+    *graph = reduceGraph(graph, order, memory, window, pruned);
+    return true;
+
+}
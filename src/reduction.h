@@ -0,0 +1,51 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include "graph.h"
+
+
+using namespace std;
+
+
+/* Memory given to the reachability bitsets by default. Larger budgets mean fewer, wider blocks */
+#define REDUCTION_MEMORY ((size_t) 256 << 20)
+
+
+/**
+ * @brief Builds the transitive reduction of a graph placed without cycles: an edge is dropped when
+ *        its child can also be reached through another child, so every piece still falls, no piece
+ *        gains or loses a parent of its own and the longest sequence is unchanged (a dropped edge
+ *        always skips a longer way around). Reachability is kept in bitsets over the topological
+ *        positions, one block of positions at a time, so memory stays within the given budget;
+ *        every node only ORs the bitsets of the children it keeps, which on dense graphs are few.
+ *        Repeated edges are dropped as well. The copy gets its own arena and keeps node numbers.
+ *        Exact reduction costs about nodes * nodes / 64 word operations, so large sparse graphs may
+ *        limit how far back a block looks for parents: edges coming from further away are kept,
+ *        which leaves some implied edges in but never changes any answer.
+ *
+ * @param graph graph to be reduced
+ * @param order every node in topological order, as given by getRelabelOrder
+ * @param memory bytes the reachability bitsets may take
+ * @param window how many positions before a block its parents are looked for (0 for all of them)
+ * @param pruned receives the number of edges dropped
+ * @return reduced graph
+ */
+Graph reduceGraph(const Graph* graph, const vector<int>& order, size_t memory, size_t window,
+                  size_t* pruned);
+
+
+/**
+ * @brief Replaces a graph by its transitive reduction, ordering it with a DFS first. Graphs placed
+ *        with cycles have no single reduction, so they are left as they are (and marked as cyclic).
+ *
+ * @param graph graph to be reduced
+ * @param pruned receives the number of edges dropped
+ * @param window how many positions before a block its parents are looked for (0 for all of them)
+ * @param memory bytes the reachability bitsets may take
+ * @return whether the graph was reduced
+ */
+bool reduceTransitiveEdges(Graph* graph, size_t* pruned, size_t window = 0,
+                           size_t memory = REDUCTION_MEMORY);
+
+
+#endif // REDUCTION_H
@@ -0,0 +1,87 @@
+#include "relabel.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Orders the nodes so that renumbering them by that order keeps related nodes close in
+ *        memory. "dfs" follows the DFS topological order, which keeps long chains together, and
+ *        "bfs" follows a breadth first topological order (Kahn's with a queue), which keeps every
+ *        node's children together. Without cycles both are topological, so a graph renumbered by
+ *        them can be relaxed in node order. Nodes on a cycle are left at the end of the bfs order.
+ *
+ * @param graph graph to be renumbered. Marked as cyclic if a cycle is found
+ * @param strategy how nodes are ordered (dfs or bfs)
+ * @return every node in its new order, so the node at position i gets number i + 1
+ */
+vector<int> getRelabelOrder(Graph* graph, const string& strategy) {
+
+    int nodes = graph->getNumberOfNodes();
+
+    if (strategy == "dfs") {
+        topologicalOrder topological = graph->dfs();
+        return vector<int>(topological.begin(), topological.end());
+    }
+
+    /* The order itself is the queue: nodes are appended once their last parent was taken out */
+    vector<int> order;
+    order.reserve(nodes);
+    arenaVector<int> remaining(nodes, 0, graph->getAllocator());
+    for (int node = 1; node <= nodes; node++) {
+        remaining[node-1] = graph->getNodeInDegree(node);
+        if (remaining[node-1] == 0) order.push_back(node);
+    }
+
+    for (size_t next = 0; next < order.size(); next++)
+        for (int child : graph->getAdjacentNodes(order[next]))
+            if (--remaining[child-1] == 0) order.push_back(child);
+
+    /* Nodes on a cycle, or reached from one, never ran out of parents */
+    if ((int) order.size() < nodes) {
+        graph->markCycle();
+        for (int node = 1; node <= nodes; node++)
+            if (remaining[node-1] > 0) order.push_back(node);
+    }
+
+    return order;
+
+}
+
+
+/**
+ * @brief Builds a copy of a graph with its nodes renumbered, every node's children sorted by their
+ *        new number. The copy gets its own arena, so the original can be released right after.
+ *
+ * @param graph graph to be renumbered
+ * @param order every node in its new order, as given by getRelabelOrder
+ * @return renumbered graph
+ */
+Graph relabelGraph(const Graph* graph, const vector<int>& order) {
+
+    int nodes = graph->getNumberOfNodes();
+    size_t edges = graph->getNumberOfEdges();
+
+    /* Holds every node's new number */
+    vector<int> label(nodes);
+    for (int i = 0; i < nodes; i++) label[order[i]-1] = i + 1;
+
+    Graph relabelled(nodes, edges, make_shared<Arena>(Graph::getArenaBytes(nodes, edges)));
+    for (int node = 1; node <= nodes; node++)
+        relabelled.addNodeDegrees(label[node-1], graph->getAdjacentNodes(node).size(),
+                                  graph->getNodeInDegree(node));
+
+    /* Nodes are filled in their new order, so the adjacency is written front to back */
+    relabelled.allocateAdjacency();
+    vector<int> children;
+    for (int node = 1; node <= nodes; node++) {
+        children.clear();
+        for (int child : graph->getAdjacentNodes(order[node-1])) children.push_back(label[child-1]);
+        sort(children.begin(), children.end());
+        for (int child : children) relabelled.placeEdge(node, child);
+    }
+    relabelled.finishAdjacency();
+
+    return relabelled;
+
+}
@@ -0,0 +1,36 @@
+#ifndef RELABEL_H
+#define RELABEL_H
+
+#include <string>
+#include "graph.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Orders the nodes so that renumbering them by that order keeps related nodes close in
+ *        memory. "dfs" follows the DFS topological order, which keeps long chains together, and
+ *        "bfs" follows a breadth first topological order (Kahn's with a queue), which keeps every
+ *        node's children together. Without cycles both are topological, so a graph renumbered by
+ *        them can be relaxed in node order. Nodes on a cycle are left at the end of the bfs order.
+ *
+ * @param graph graph to be renumbered. Marked as cyclic if a cycle is found
+ * @param strategy how nodes are ordered (dfs or bfs)
+ * @return every node in its new order, so the node at position i gets number i + 1
+ */
+vector<int> getRelabelOrder(Graph* graph, const string& strategy);
+
+
+/**
+ * @brief Builds a copy of a graph with its nodes renumbered, every node's children sorted by their
+ *        new number. The copy gets its own arena, so the original can be released right after.
+ *
+ * @param graph graph to be renumbered
+ * @param order every node in its new order, as given by getRelabelOrder
+ * @return renumbered graph
+ */
+Graph relabelGraph(const Graph* graph, const vector<int>& order);
+
+
+#endif // RELABEL_H
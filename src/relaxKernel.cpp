@@ -0,0 +1,136 @@
+#include <immintrin.h>
+#include "relaxKernel.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief Scalar relaxation, one child at a time. Used on CPUs without AVX2 and for the children
+ *        left over by the vector kernels.
+ *
+ * @param distances every node's distance, node n at position n - 1
+ * @param children the node's children
+ * @param count number of children
+ * @param dist candidate distance (the node's one plus 1)
+ * @return number of distances that grew
+ */
+static size_t relaxScalar(int* distances, const int* children, size_t count, int dist) {
+    size_t updated = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (distances[children[i]-1] < dist) {
+            distances[children[i]-1] = dist;
+            updated++;
+        }
+    }
+    return updated;
+}
+
+
+#ifndef DOMINO_NO_SIMD
+
+/**
+ * @brief AVX2 relaxation, 8 children at a time. Their distances are gathered and compared with the
+ *        candidate one. AVX2 has no scatter, so only the lanes that grow are stored, one by one,
+ *        each checked again so that a child repeated among them is only counted once.
+ *
+ * @param distances every node's distance, node n at position n - 1
+ * @param children the node's children
+ * @param count number of children
+ * @param dist candidate distance (the node's one plus 1)
+ * @return number of distances that grew
+ */
+__attribute__((target("avx2")))
+static size_t relaxAvx2(int* distances, const int* children, size_t count, int dist) {
+
+    const __m256i candidate = _mm256_set1_epi32(dist), one = _mm256_set1_epi32(1);
+    size_t updated = 0, i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i index = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*) (children + i)), one);
+        __m256i current = _mm256_i32gather_epi32(distances, index, 4);
+        __m256i greater = _mm256_cmpgt_epi32(candidate, current);
+        unsigned grow = _mm256_movemask_ps(_mm256_castsi256_ps(greater));
+        for (; grow != 0; grow &= grow - 1) {
+            int child = children[i + __builtin_ctz(grow)];
+            if (distances[child-1] >= dist) continue;
+            distances[child-1] = dist;
+            updated++;
+        }
+    }
+
+    return updated + relaxScalar(distances, children + i, count - i, dist);
+
+}
+
+
+/**
+ * @brief AVX-512 relaxation, 16 children at a time. Their distances are gathered, compared with the
+ *        candidate one and scattered back only where they grow. Lanes repeating an earlier growing
+ *        lane's child are found with AVX-512 CD and left out, so each child is counted once. The
+ *        last children are handled by the same loop with a partial mask.
+ *
+ * @param distances every node's distance, node n at position n - 1
+ * @param children the node's children
+ * @param count number of children
+ * @param dist candidate distance (the node's one plus 1)
+ * @return number of distances that grew
+ */
+__attribute__((target("avx512f,avx512cd")))
+static size_t relaxAvx512(int* distances, const int* children, size_t count, int dist) {
+
+    const __m512i candidate = _mm512_set1_epi32(dist), one = _mm512_set1_epi32(1);
+    size_t updated = 0;
+
+    for (size_t i = 0; i < count; i += 16) {
+        __mmask16 lanes = count - i >= 16 ? (__mmask16) 0xFFFF
+                                          : (__mmask16) ((1u << (count - i)) - 1);
+        __m512i index = _mm512_maskz_sub_epi32(lanes, _mm512_maskz_loadu_epi32(lanes, children + i),
+                                               one);
+        __m512i current = _mm512_mask_i32gather_epi32(candidate, lanes, index, distances, 4);
+        __mmask16 grow = _mm512_mask_cmpgt_epi32_mask(lanes, candidate, current);
+        __m512i earlier = _mm512_maskz_conflict_epi32(grow, index);
+        grow &= ~_mm512_mask_test_epi32_mask(grow, earlier, _mm512_set1_epi32(grow));
+        _mm512_mask_i32scatter_epi32(distances, grow, index, candidate, 4);
+        updated += __builtin_popcount(grow);
+    }
+
+    return updated;
+
+}
+
+#endif
+
+
+/**
+ * @brief Gets the relaxation kernel for this CPU, chosen once through CPUID: AVX-512 gathers and
+ *        masked scatters, AVX2 gathers with scalar stores for the lanes that grow, or plain scalar
+ *        code. Building with -DDOMINO_NO_SIMD always gives the scalar one.
+ *
+ * @return relaxation kernel
+ */
+relaxKernel getRelaxKernel() {
+#ifndef DOMINO_NO_SIMD
+    static const relaxKernel kernel = __builtin_cpu_supports("avx512f") &&
+                                      __builtin_cpu_supports("avx512cd") ? relaxAvx512
+                                    : __builtin_cpu_supports("avx2") ? relaxAvx2 : relaxScalar;
+    return kernel;
+#else
+    return relaxScalar;
+#endif
+}
+
+
+/**
+ * @brief Get the Relax Kernel Name object.
+ *
+ * @return name of the kernel getRelaxKernel gives (avx512, avx2 or scalar)
+ */
+const char* getRelaxKernelName() {
+#ifndef DOMINO_NO_SIMD
+    relaxKernel kernel = getRelaxKernel();
+    if (kernel == relaxAvx512) return "avx512";
+    if (kernel == relaxAvx2) return "avx2";
+#endif
+    return "scalar";
+}
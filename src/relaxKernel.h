@@ -0,0 +1,42 @@
+#ifndef RELAX_KERNEL_H
+#define RELAX_KERNEL_H
+
+#include <cstddef>
+
+
+using namespace std;
+
+
+/**
+ * @brief Raises the distance of every child of a node to at least a given one. All the children
+ *        get the same candidate distance, so lanes holding the same child always write the same
+ *        value. A repeated child still grows only once, so every kernel returns the same count.
+ *
+ * @param distances every node's distance, node n at position n - 1
+ * @param children the node's children
+ * @param count number of children
+ * @param dist candidate distance (the node's one plus 1)
+ * @return number of distances that grew
+ */
+typedef size_t (*relaxKernel)(int* distances, const int* children, size_t count, int dist);
+
+
+/**
+ * @brief Gets the relaxation kernel for this CPU, chosen once through CPUID: AVX-512 gathers and
+ *        masked scatters, AVX2 gathers with scalar stores for the lanes that grow, or plain scalar
+ *        code. Building with -DDOMINO_NO_SIMD always gives the scalar one.
+ *
+ * @return relaxation kernel
+ */
+relaxKernel getRelaxKernel();
+
+
+/**
+ * @brief Get the Relax Kernel Name object.
+ *
+ * @return name of the kernel getRelaxKernel gives (avx512, avx2 or scalar)
+ */
+const char* getRelaxKernelName();
+
+
+#endif // RELAX_KERNEL_H
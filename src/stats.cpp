@@ -0,0 +1,97 @@
+#include <cstdlib>
+#include <new>
+#include "relaxKernel.h"
+#include "stats.h"
+
+
+using namespace std;
+
+
+solverStatsStruct solverStats;
+
+
+#ifdef DOMINO_STATS
+
+/**
+ * @brief Counts every allocation made through new before handing it to malloc.
+ *
+ * @param size number of bytes asked
+ * @return allocated memory
+ */
+void* operator new(size_t size) {
+    STATS_ADD(allocations, 1);
+    STATS_ADD(allocatedBytes, size);
+    void* memory = malloc(size ? size : 1);
+    if (memory == nullptr) throw bad_alloc();
+    return memory;
+}
+
+
+/**
+ * @brief Gives memory taken by the counting operator new back to malloc.
+ *
+ * @param memory memory to be released
+ */
+void operator delete(void* memory) noexcept { free(memory); }
+
+#endif
+
+
+/**
+ * @brief Ends the running phase, if any, and starts a new one.
+ *
+ * @param name phase name
+ */
+void PhaseTimer::start(const string& name) {
+    this->stop();
+    this->_current = name;
+    this->_start = chrono::steady_clock::now();
+}
+
+
+/**
+ * @brief Ends the running phase, if any.
+ */
+void PhaseTimer::stop() {
+    if (this->_current.empty()) return;
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - this->_start;
+    this->_phases.emplace_back(this->_current, elapsed.count());
+    this->_current.clear();
+}
+
+
+/**
+ * @brief Get the Phases object.
+ *
+ * @return every finished phase's name and seconds, in the order they ran
+ */
+const vector<pair<string, double>>& PhaseTimer::getPhases() const { return this->_phases; }
+
+
+/**
+ * @brief Prints every phase's wall time, the peak DFS auxiliary size and, when built with
+ *        -DDOMINO_STATS, every counter of solverStats.
+ *
+ * @param out stream the report is written to
+ * @param timer phases measured
+ * @param peakDfsAuxSize most frames the DFS held at once (0 if it did not run)
+ */
+void printStats(ostream& out, const PhaseTimer& timer, size_t peakDfsAuxSize) {
+
+    for (const auto& phase : timer.getPhases())
+        out << "phase " << phase.first << ": " << phase.second << " s" << endl;
+    out << "peak dfs aux size: " << peakDfsAuxSize << endl;
+    out << "relax kernel: " << getRelaxKernelName() << endl;
+
+#ifdef DOMINO_STATS
+    out << "edges relaxed: " << solverStats.edgesRelaxed << endl;
+    out << "distance updates: " << solverStats.distanceUpdates << endl;
+    out << "dfs pushes: " << solverStats.dfsPushes << endl;
+    out << "dfs visits: " << solverStats.dfsVisits << endl;
+    out << "allocations: " << solverStats.allocations << " (" << solverStats.allocatedBytes
+        << " bytes)" << endl;
+#else
+    out << "counters: not built in, build with -DDOMINO_STATS (make stats)" << endl;
+#endif
+
+}
@@ -0,0 +1,112 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+using namespace std;
+
+
+/**
+ * @brief Counters of the solvers' hot paths. They are only updated when built with -DDOMINO_STATS,
+ *        otherwise STATS_ADD expands to nothing and the hot paths are exactly as without them.
+ *
+ * @param edgesRelaxed edges walked while finding the longest path
+ * @param distanceUpdates distances that actually grew while relaxing those edges
+ * @param dfsPushes frames pushed on the DFS auxiliary stack
+ * @param dfsVisits nodes closed by the DFS, each exactly once
+ * @param allocations calls to operator new
+ * @param allocatedBytes bytes asked to operator new
+ */
+typedef struct solverStatsStruct {
+    atomic<uint64_t> edgesRelaxed;
+    atomic<uint64_t> distanceUpdates;
+    atomic<uint64_t> dfsPushes;
+    atomic<uint64_t> dfsVisits;
+    atomic<uint64_t> allocations;
+    atomic<uint64_t> allocatedBytes;
+} solverStatsStruct;
+
+
+/**
+ * @brief Counters of the whole program. Zero initialized before main runs.
+ */
+extern solverStatsStruct solverStats;
+
+
+/**
+ * @brief Adds an amount to one of solverStats' counters, or nothing unless built with -DDOMINO_STATS.
+ *        Hot loops should add their local totals once instead of counting every step. Without the
+ *        counters the amount is not even evaluated, so it may be a local only kept for them.
+ */
+#ifdef DOMINO_STATS
+#define STATS_ADD(counter, amount) solverStats.counter.fetch_add(amount, memory_order_relaxed)
+#else
+#define STATS_ADD(counter, amount) ((void) sizeof(amount))
+#endif
+
+
+/**
+ * @brief Measures the wall time of the program's phases, one after the other.
+ */
+class PhaseTimer {
+
+    private:
+
+        /**
+         * @brief Holds every finished phase's name and seconds.
+         */
+        vector<pair<string, double>> _phases;
+
+        /**
+         * @brief Holds the running phase's name, empty if none is running.
+         */
+        string _current;
+
+        /**
+         * @brief Holds when the running phase started.
+         */
+        chrono::steady_clock::time_point _start;
+
+    public:
+
+        /**
+         * @brief Ends the running phase, if any, and starts a new one.
+         *
+         * @param name phase name
+         */
+        void start(const string& name);
+
+        /**
+         * @brief Ends the running phase, if any.
+         */
+        void stop();
+
+        /**
+         * @brief Get the Phases object.
+         *
+         * @return every finished phase's name and seconds, in the order they ran
+         */
+        const vector<pair<string, double>>& getPhases() const;
+
+};
+
+
+/**
+ * @brief Prints every phase's wall time, the peak DFS auxiliary size and, when built with
+ *        -DDOMINO_STATS, every counter of solverStats.
+ *
+ * @param out stream the report is written to
+ * @param timer phases measured
+ * @param peakDfsAuxSize most frames the DFS held at once (0 if it did not run)
+ */
+void printStats(ostream& out, const PhaseTimer& timer, size_t peakDfsAuxSize);
+
+
+#endif // STATS_H
@@ -0,0 +1,116 @@
+#include "workStealingDeque.h"
+
+
+using namespace std;
+
+
+/**
+ * @brief WorkStealingDeque constructor.
+ *
+ * @param capacity initial capacity, rounded up to a power of 2
+ */
+WorkStealingDeque::WorkStealingDeque(long capacity) : _top(0), _bottom(0) {
+    long size = 1;
+    while (size < capacity) size <<= 1;
+    this->_buffers.emplace_back(new bufferStruct(size));
+    this->_buffer.store(this->_buffers.back().get(), memory_order_relaxed);
+}
+
+
+/**
+ * @brief Replaces the array with one twice as big, holding the same nodes.
+ *
+ * @param top position of the oldest node
+ * @param bottom position past the newest node
+ * @return new array
+ */
+WorkStealingDeque::bufferStruct* WorkStealingDeque::grow(long top, long bottom) {
+
+    bufferStruct* old = this->_buffer.load(memory_order_relaxed);
+    bufferStruct* bigger = new bufferStruct((old->mask + 1) * 2);
+    this->_buffers.emplace_back(bigger);
+
+    for (long i = top; i < bottom; i++) {
+        int node = old->items[i & old->mask].load(memory_order_relaxed);
+        bigger->items[i & bigger->mask].store(node, memory_order_relaxed);
+    }
+
+    this->_buffer.store(bigger, memory_order_release);
+    return bigger;
+
+}
+
+
+/**
+ * @brief Inserts a node at the bottom. Only the owner may call it.
+ *
+ * @param node node value
+ */
+void WorkStealingDeque::push(int node) {
+
+    long bottom = this->_bottom.load(memory_order_relaxed);
+    long top = this->_top.load(memory_order_acquire);
+    bufferStruct* buffer = this->_buffer.load(memory_order_relaxed);
+
+    if (bottom - top > buffer->mask) buffer = this->grow(top, bottom);
+
+    buffer->items[bottom & buffer->mask].store(node, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    this->_bottom.store(bottom + 1, memory_order_relaxed);
+
+}
+
+
+/**
+ * @brief Removes the newest node. Only the owner may call it.
+ *
+ * @param node where the node is stored
+ * @return true if there was a node
+ */
+bool WorkStealingDeque::pop(int& node) {
+
+    long bottom = this->_bottom.load(memory_order_relaxed) - 1;
+    bufferStruct* buffer = this->_buffer.load(memory_order_relaxed);
+    this->_bottom.store(bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = this->_top.load(memory_order_relaxed);
+
+    /* Already empty */
+    if (top > bottom) {
+        this->_bottom.store(bottom + 1, memory_order_relaxed);
+        return false;
+    }
+
+    node = buffer->items[bottom & buffer->mask].load(memory_order_relaxed);
+    if (top < bottom) return true;
+
+    /* Last node left: a thief may be taking it at the same time, whoever moves top wins it */
+    bool won = this->_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst,
+                                                  memory_order_relaxed);
+    this->_bottom.store(bottom + 1, memory_order_relaxed);
+    return won;
+
+}
+
+
+/**
+ * @brief Removes the oldest node. Any worker may call it.
+ *
+ * @param node where the node is stored
+ * @return true if a node was stolen. False if there was none or another worker won the race
+ */
+bool WorkStealingDeque::steal(int& node) {
+
+    long top = this->_top.load(memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = this->_bottom.load(memory_order_acquire);
+
+    if (top >= bottom) return false;
+
+    bufferStruct* buffer = this->_buffer.load(memory_order_acquire);
+    node = buffer->items[top & buffer->mask].load(memory_order_relaxed);
+
+    return this->_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst,
+                                              memory_order_relaxed);
+
+}
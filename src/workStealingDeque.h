@@ -0,0 +1,99 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+using namespace std;
+
+
+/**
+ * @brief Chase-Lev work stealing deque of node values (Le et al., "Correct and Efficient
+ *        Work-Stealing for Weak Memory Models"). Its owner pushes and pops at the bottom, like a
+ *        stack, while any other worker may steal the oldest node from the top.
+ */
+class WorkStealingDeque {
+
+    private:
+
+        /**
+         * @brief Circular array holding the nodes. Its capacity is always a power of 2.
+         *
+         * @param mask capacity - 1, used to wrap positions around
+         * @param items every slot of the array
+         */
+        typedef struct bufferStruct {
+            long mask;
+            unique_ptr<atomic<int>[]> items;
+            explicit bufferStruct(long capacity)
+                : mask(capacity - 1), items(new atomic<int>[capacity]) {};
+        } bufferStruct;
+
+        /**
+         * @brief Holds the position of the oldest node, where thieves steal from.
+         */
+        atomic<long> _top;
+
+        /**
+         * @brief Holds the position past the newest node, where the owner pushes and pops.
+         */
+        atomic<long> _bottom;
+
+        /**
+         * @brief Holds the array currently in use.
+         */
+        atomic<bufferStruct*> _buffer;
+
+        /**
+         * @brief Holds every array ever used. Old ones may still be read by a late thief, so they
+         *        are only freed with the deque.
+         */
+        vector<unique_ptr<bufferStruct>> _buffers;
+
+        /**
+         * @brief Replaces the array with one twice as big, holding the same nodes.
+         *
+         * @param top position of the oldest node
+         * @param bottom position past the newest node
+         * @return new array
+         */
+        bufferStruct* grow(long top, long bottom);
+
+    public:
+
+        /**
+         * @brief WorkStealingDeque constructor.
+         *
+         * @param capacity initial capacity, rounded up to a power of 2
+         */
+        explicit WorkStealingDeque(long capacity = 1024);
+
+        /**
+         * @brief Inserts a node at the bottom. Only the owner may call it.
+         *
+         * @param node node value
+         */
+        void push(int node);
+
+        /**
+         * @brief Removes the newest node. Only the owner may call it.
+         *
+         * @param node where the node is stored
+         * @return true if there was a node
+         */
+        bool pop(int& node);
+
+        /**
+         * @brief Removes the oldest node. Any worker may call it.
+         *
+         * @param node where the node is stored
+         * @return true if a node was stolen. False if there was none or another worker won the race
+         */
+        bool steal(int& node);
+
+};
+
+
+#endif // WORK_STEALING_DEQUE_H